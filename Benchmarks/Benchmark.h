@@ -0,0 +1,76 @@
+#pragma once
+
+// Build with BENCHMARK_WIDE_IDENTIFIERS defined to measure the engine with 64-bit entity identifiers
+#ifdef BENCHMARK_WIDE_IDENTIFIERS
+#include <Engine/Entities/Entity/EntityTraits.hpp>
+
+template <>
+struct ecs::EntityTraits<> : ecs::EntityLayout64 {};
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include <cstddef>
+
+namespace bench
+{
+	/**
+	* @brief Named measurement of the engine.
+	*
+	* Benchmarks register themselves on startup (see `BENCHMARK`) and print their own
+	* results, as each of them compares several variants of an operation.
+	*/
+	struct Benchmark final
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	inline std::vector<Benchmark>& benchmarks() {
+		static auto list = std::vector<Benchmark>();
+		return list;
+	}
+
+	struct Registration final
+	{
+		Registration(const char* name, void (*run)()) {
+			benchmarks().push_back({ name, run });
+		}
+	};
+
+	// Amount of allocations made through the global operator new so far (see Main.cpp)
+	std::size_t allocations();
+
+	// Best wall time of the runs in milliseconds, as the other ones are slowed down by the rest of the system
+	template <typename Function>
+	double best(unsigned runs, Function&& function) {
+		auto result = std::numeric_limits<double>::max();
+
+		for (auto run = 0U; run < runs; ++run) {
+			auto start = std::chrono::steady_clock::now();
+			function();
+			auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			result = elapsed < result ? elapsed : result;
+		}
+
+		return result;
+	}
+
+	inline volatile double sink = 0.0;
+
+	// Keeps the compiler from optimizing away the computation of the value
+	inline void keep(double value) {
+		sink = value;
+	}
+
+	inline void report(const char* label, double value, const char* unit) {
+		std::printf("  %-52s %12.3f %s\n", label, value, unit);
+	}
+}
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static const bench::Registration name##Registration(#name, &name); \
+	static void name()
@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+
+#include <string>
+#include <functional>
+
+#include <Engine/Messages/MessageManager.hpp>
+#include <Engine/Entities/Entity/Entity.hpp>
+#include <Engine/Entities/Entity/EntityManager.hpp>
+
+namespace
+{
+	template <unsigned>
+	struct Value
+	{
+		float value = 1.f;
+	};
+
+	using A = Value<0U>;
+	using B = Value<1U>;
+	using C = Value<2U>;
+	using D = Value<3U>;
+
+	// Per-entity cost of each when the callback is inlined, and when it is erased behind a std::function as it used to be
+	template <typename... Components>
+	void compare(ecs::EntityManager& world) {
+		auto sum = 0.f;
+		auto count = double(world.count<A>());
+		auto inlined = [&](auto&, auto&... components) {
+			sum += (0.f + ... + components.value);
+		};
+		auto erased = std::function<void(ecs::Entity&, Components&...)>(inlined);
+
+		auto templated = bench::best(10U, [&]() {
+			world.each<Components...>(inlined);
+		});
+
+		auto wrapped = bench::best(10U, [&]() {
+			world.each<Components...>(erased);
+		});
+
+		auto components = std::to_string(sizeof...(Components)) + " components";
+		bench::report(("template callback, " + components).c_str(), templated * 1000000.0 / count, "ns");
+		bench::report(("std::function callback, " + components).c_str(), wrapped * 1000000.0 / count, "ns");
+		bench::keep(sum);
+	}
+}
+
+// Iteration over 1M entities having four components, visiting one to four of them
+BENCHMARK(Callbacks)
+{
+	auto messages = std::make_shared<mqs::MessageManager>();
+	auto world = ecs::EntityManager(messages);
+	world.create(1000000U, A(), B(), C(), D());
+
+	compare<A>(world);
+	compare<A, B>(world);
+	compare<A, B, C>(world);
+	compare<A, B, C, D>(world);
+}
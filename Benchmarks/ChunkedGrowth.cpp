@@ -0,0 +1,58 @@
+#include "Benchmark.h"
+
+#include <chrono>
+#include <string>
+
+#include <Engine/Messages/MessageManager.hpp>
+#include <Engine/Entities/Entity/Entity.hpp>
+#include <Engine/Entities/Entity/EntityManager.hpp>
+
+namespace
+{
+	template <unsigned>
+	struct Payload
+	{
+		float values[8] = {}; // 32 bytes
+	};
+
+	using Contiguous = Payload<0U>;
+	using Chunked = Payload<1U>;
+}
+
+template <>
+struct ecs::ComponentStorage<Chunked>
+{
+	using type = ecs::ChunkedStorage<Chunked>;
+};
+
+namespace
+{
+	// Times every single addition, the worst ones being the reallocations as the collection grows
+	template <typename Component>
+	void grow(const char* storage, unsigned count) {
+		auto messages = std::make_shared<mqs::MessageManager>();
+		auto world = ecs::EntityManager(messages);
+		auto entities = world.create(count);
+		auto worst = 0.0;
+		auto total = 0.0;
+
+		for (auto& entity : entities) {
+			auto start = std::chrono::steady_clock::now();
+			world.assign<Component>(entity.id());
+			auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+			worst = elapsed > worst ? elapsed : worst;
+			total += elapsed;
+		}
+
+		bench::report((std::string(storage) + " storage, worst add").c_str(), worst / 1000.0, "ms");
+		bench::report((std::string(storage) + " storage, mean add").c_str(), total / count, "us");
+	}
+}
+
+// Latency of adding 2M components of 32 bytes one at a time, with contiguous and chunked storages
+BENCHMARK(ChunkedGrowth)
+{
+	grow<Contiguous>("vector", 2000000U);
+	grow<Chunked>("chunked", 2000000U);
+}
@@ -0,0 +1,56 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include <Engine/Messages/MessageManager.hpp>
+#include <Engine/Entities/Entity/Entity.hpp>
+#include <Engine/Entities/Entity/EntityManager.hpp>
+
+namespace
+{
+	template <unsigned>
+	struct Value
+	{
+		float value = 1.f;
+	};
+
+	using Position = Value<0U>;
+	using Velocity = Value<1U>;
+	using Health = Value<2U>; // Every other entity, so that the sparse lookups reject half of them
+}
+
+// Iteration throughput over 1M entities with the identifiers of the build, compare with BENCHMARK_WIDE_IDENTIFIERS
+BENCHMARK(Identifiers)
+{
+	const auto ENTITIES = 1000000U;
+
+	auto messages = std::make_shared<mqs::MessageManager>();
+	auto world = ecs::EntityManager(messages);
+	auto entities = world.create(ENTITIES, Position(), Velocity());
+	auto sum = 0.f;
+
+	for (auto index = 0U; index < ENTITIES; index += 2U) {
+		world.assign<Health>(entities[index].id());
+	}
+
+	auto width = std::to_string(sizeof(ecs::EntityId) * 8U) + "-bit identifiers";
+	bench::report(("each<P>, " + width).c_str(), bench::best(10U, [&]() {
+		world.each<Position>([&](auto&, auto& position) {
+			sum += position.value;
+		});
+	}), "ms");
+
+	bench::report(("each<P, V>, " + width).c_str(), bench::best(10U, [&]() {
+		world.each<Position, Velocity>([&](auto&, auto& position, auto& velocity) {
+			sum += position.value * velocity.value;
+		});
+	}), "ms");
+
+	bench::report(("each<H, V>, " + width).c_str(), bench::best(10U, [&]() {
+		world.each<Health, Velocity>([&](auto&, auto& health, auto& velocity) {
+			sum += health.value * velocity.value;
+		});
+	}), "ms");
+
+	bench::keep(sum);
+}
@@ -0,0 +1,124 @@
+#include "Benchmark.h"
+
+#include <Engine/Messages/MessageManager.hpp>
+#include <Engine/Entities/Entity/Entity.hpp>
+#include <Engine/Entities/Entity/EntityManager.hpp>
+
+namespace
+{
+	template <unsigned>
+	struct Vector
+	{
+		float x = 1.f;
+		float y = 1.f;
+		float z = 1.f;
+	};
+
+	using Position = Vector<0U>;
+	using Velocity = Vector<1U>;
+	using SoAPosition = Vector<2U>;
+	using SoAVelocity = Vector<3U>;
+}
+
+template <>
+struct ecs::ComponentStorage<SoAPosition>
+{
+	using type = ecs::SoAStorage<&SoAPosition::x, &SoAPosition::y, &SoAPosition::z>;
+};
+
+template <>
+struct ecs::ComponentStorage<SoAVelocity>
+{
+	using type = ecs::SoAStorage<&SoAVelocity::x, &SoAVelocity::y, &SoAVelocity::z>;
+};
+
+namespace
+{
+	const auto DELTA = 0.016f;
+	const auto BODIES = 1000000U;
+	const auto FRAMES = 20U;
+
+	template <typename Pass>
+	void measure(const char* label, Pass&& pass) {
+		bench::report(label, bench::best(FRAMES, pass), "ms");
+	}
+}
+
+// Integration of 1M bodies whose positions and velocities are grouped, stored as arrays of structures or structures of arrays
+BENCHMARK(Layouts)
+{
+	auto messages = std::make_shared<mqs::MessageManager>();
+	auto world = ecs::EntityManager(messages);
+	world.group<Position, Velocity>();
+	world.group<SoAPosition, SoAVelocity>();
+	world.create(BODIES, Position(), Velocity(), SoAPosition(), SoAVelocity());
+
+	measure("all fields, AoS each", [&]() {
+		world.each<Position, Velocity>([](auto&, auto& position, auto& velocity) {
+			position.x += velocity.x * DELTA;
+			position.y += velocity.y * DELTA;
+			position.z += velocity.z * DELTA;
+		});
+	});
+
+	measure("all fields, AoS raw loop", [&]() {
+		auto positions = world.collection<Position>().raw();
+		auto velocities = world.collection<Velocity>().raw();
+
+		for (auto index = 0U; index < BODIES; ++index) {
+			positions[index].x += velocities[index].x * DELTA;
+			positions[index].y += velocities[index].y * DELTA;
+			positions[index].z += velocities[index].z * DELTA;
+		}
+	});
+
+	measure("all fields, SoA proxies in each", [&]() {
+		world.each<SoAPosition, SoAVelocity>([](auto&, auto&& position, auto&& velocity) {
+			position[&SoAPosition::x] += velocity[&SoAVelocity::x] * DELTA;
+			position[&SoAPosition::y] += velocity[&SoAVelocity::y] * DELTA;
+			position[&SoAPosition::z] += velocity[&SoAVelocity::z] * DELTA;
+		});
+	});
+
+	measure("all fields, SoA field arrays", [&]() {
+		auto& positions = world.collection<SoAPosition>().storage();
+		auto& velocities = world.collection<SoAVelocity>().storage();
+		auto px = positions.data(&SoAPosition::x), py = positions.data(&SoAPosition::y), pz = positions.data(&SoAPosition::z);
+		auto vx = velocities.data(&SoAVelocity::x), vy = velocities.data(&SoAVelocity::y), vz = velocities.data(&SoAVelocity::z);
+
+		for (auto index = 0U; index < BODIES; ++index) {
+			px[index] += vx[index] * DELTA;
+			py[index] += vy[index] * DELTA;
+			pz[index] += vz[index] * DELTA;
+		}
+	});
+
+	measure("x and y only, AoS raw loop", [&]() {
+		auto positions = world.collection<Position>().raw();
+		auto velocities = world.collection<Velocity>().raw();
+
+		for (auto index = 0U; index < BODIES; ++index) {
+			positions[index].x += velocities[index].x * DELTA;
+			positions[index].y += velocities[index].y * DELTA;
+		}
+	});
+
+	measure("x and y only, SoA field arrays", [&]() {
+		auto& positions = world.collection<SoAPosition>().storage();
+		auto& velocities = world.collection<SoAVelocity>().storage();
+		auto px = positions.data(&SoAPosition::x), py = positions.data(&SoAPosition::y);
+		auto vx = velocities.data(&SoAVelocity::x), vy = velocities.data(&SoAVelocity::y);
+
+		for (auto index = 0U; index < BODIES; ++index) {
+			px[index] += vx[index] * DELTA;
+			py[index] += vy[index] * DELTA;
+		}
+	});
+
+	auto sum = 0.0;
+	world.each<Position, SoAPosition>([&](auto&, auto& position, auto&& other) {
+		sum += position.x + other[&SoAPosition::x];
+	});
+
+	bench::keep(sum);
+}
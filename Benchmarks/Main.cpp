@@ -0,0 +1,86 @@
+#include "Benchmark.h"
+
+#include <new>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace
+{
+	std::atomic<std::size_t> counter = 0U;
+}
+
+// Counts the allocations of the whole program, so that benchmarks may report the ones they make
+void* operator new(std::size_t size) {
+	counter.fetch_add(1U, std::memory_order_relaxed);
+
+	if (auto memory = std::malloc(size ? size : 1U)) {
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+// Memory resources of the standard library allocate through the aligned forms
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	counter.fetch_add(1U, std::memory_order_relaxed);
+
+	auto bytes = (std::max<std::size_t>(size, 1U) + std::size_t(alignment) - 1U) & ~(std::size_t(alignment) - 1U);
+#ifdef _MSC_VER
+	if (auto memory = _aligned_malloc(bytes, std::size_t(alignment))) {
+#else
+	if (auto memory = std::aligned_alloc(std::size_t(alignment), bytes)) {
+#endif
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+#ifdef _MSC_VER
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+	operator delete(memory, alignment);
+}
+
+std::size_t bench::allocations() {
+	return counter.load(std::memory_order_relaxed);
+}
+
+// Runs every benchmark, or the ones named on the command line, e.g. Benchmarks ParallelEach
+int main(int argc, char** argv)
+{
+	for (const auto& benchmark : bench::benchmarks()) {
+		auto selected = argc < 2;
+
+		for (auto index = 1; index < argc; ++index) {
+			selected = selected || std::strcmp(argv[index], benchmark.name) == 0;
+		}
+
+		if (selected) {
+			std::printf("%s\n", benchmark.name);
+			benchmark.run();
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+#include "Benchmark.h"
+
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Engine/Messages/MessageManager.hpp>
+#include <Engine/Entities/Entity/Entity.hpp>
+#include <Engine/Entities/Entity/EntityManager.hpp>
+
+namespace
+{
+	struct Position
+	{
+		float x = 0.f;
+		float y = 0.f;
+	};
+
+	struct Velocity
+	{
+		float x = 1.f;
+		float y = 1.f;
+	};
+
+	void integrate(Position& position, const Velocity& velocity) {
+		position.x += velocity.x;
+		position.y += velocity.y;
+	}
+
+	// Enough arithmetic per entity for the iteration itself not to dominate
+	void simulate(Position& position, const Velocity& velocity) {
+		for (auto step = 0U; step < 32U; ++step) {
+			position.x = std::sqrt(position.x * position.x + velocity.x) * 0.5f;
+			position.y = std::sqrt(position.y * position.y + velocity.y) * 0.5f;
+		}
+	}
+
+	// Thread counts doubling up to the amount of cores, the calling thread being one of them
+	std::vector<unsigned> concurrencies() {
+		auto cores = std::max(1U, std::thread::hardware_concurrency());
+		auto result = std::vector<unsigned>();
+
+		for (auto threads = 1U; threads < cores; threads *= 2U) {
+			result.push_back(threads);
+		}
+
+		result.push_back(cores);
+		return result;
+	}
+
+	template <typename Update>
+	void measure(const char* workload, unsigned count, Update update) {
+		auto messages = std::make_shared<mqs::MessageManager>();
+		auto baseline = 0.0;
+
+		for (auto threads : concurrencies()) {
+			auto world = ecs::EntityManager(messages, std::pmr::get_default_resource(), std::make_shared<ths::ThreadPool>(threads - 1U));
+			world.create(count, Position(), Velocity());
+
+			if (threads == 1U) {
+				baseline = bench::best(5U, [&]() {
+					world.each<Position, Velocity>([&](auto&, auto& position, auto& velocity) {
+						update(position, velocity);
+					});
+				});
+
+				bench::report((std::string(workload) + " each, " + std::to_string(count) + " entities").c_str(), baseline, "ms");
+			}
+
+			auto elapsed = bench::best(5U, [&]() {
+				world.parallelEach<Position, Velocity>([&](auto&, auto& position, auto& velocity) {
+					update(position, velocity);
+				});
+			});
+
+			auto label = std::string(workload) + " parallelEach, " + std::to_string(count) + " entities, " + std::to_string(threads) + " threads";
+			bench::report(label.c_str(), elapsed, "ms");
+			bench::report("  speedup over each", baseline / elapsed, "x");
+
+			auto sum = 0.0;
+			world.each<Position>([&](auto&, auto& position) {
+				sum += position.x;
+			});
+
+			bench::keep(sum);
+		}
+	}
+}
+
+// Scaling of parallelEach against each over the cores of the machine, rerun it on the target hardware
+BENCHMARK(ParallelEach)
+{
+	for (auto count : { 100000U, 1000000U }) {
+		measure("light", count, integrate);
+		measure("heavy", count, simulate);
+	}
+}
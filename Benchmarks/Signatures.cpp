@@ -0,0 +1,85 @@
+#include "Benchmark.h"
+
+#include <chrono>
+#include <utility>
+
+#include <Engine/Messages/MessageManager.hpp>
+#include <Engine/Entities/Entity/Entity.hpp>
+#include <Engine/Entities/Entity/EntityManager.hpp>
+
+namespace
+{
+	template <std::size_t>
+	struct Tag
+	{
+		unsigned value = 0U;
+	};
+
+	const auto ENTITIES = 200000U;
+	const auto TYPES = 64U;
+	const auto RUNS = 5U;
+
+	// Gives a few entities to each of the component types, so that every collection is populated
+	template <std::size_t... Indices>
+	void populate(ecs::EntityManager& world, std::index_sequence<Indices...>) {
+		auto populating = { 0, (world.create(1000U, Tag<Indices>()), 0)... };
+	}
+
+	// Destroys every entity having the components, in a world having 64 populated component types
+	template <typename... Components>
+	double destroy() {
+		auto messages = std::make_shared<mqs::MessageManager>();
+		auto result = 0.0;
+
+		for (auto run = 0U; run < RUNS; ++run) {
+			auto world = ecs::EntityManager(messages);
+			populate(world, std::make_index_sequence<TYPES>());
+
+			auto entities = world.create(ENTITIES, Components()...);
+			auto start = std::chrono::steady_clock::now();
+
+			for (auto& entity : entities) {
+				world.destroy(entity.id());
+			}
+
+			auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ENTITIES;
+			result = run == 0U || elapsed < result ? elapsed : result;
+		}
+
+		return result;
+	}
+}
+
+// Entity destruction and membership tests against per-entity signatures, with 64 component types
+BENCHMARK(Signatures)
+{
+	bench::report("destroy, 1 component per entity", destroy<Tag<0U>>(), "ns");
+	bench::report("destroy, 8 components per entity", destroy<Tag<0U>, Tag<7U>, Tag<15U>, Tag<23U>, Tag<31U>, Tag<39U>, Tag<47U>, Tag<63U>>(), "ns");
+
+	auto messages = std::make_shared<mqs::MessageManager>();
+	auto world = ecs::EntityManager(messages);
+	populate(world, std::make_index_sequence<TYPES>());
+
+	auto entities = world.create(ENTITIES, Tag<0U>(), Tag<1U>());
+	auto matches = 0U;
+
+	// Single mask test per entity, against a sparse lookup per component type
+	auto masked = bench::best(RUNS, [&]() {
+		for (auto& entity : entities) {
+			matches += world.has<Tag<0U>, Tag<1U>, Tag<2U>>(entity.id());
+		}
+	});
+
+	auto& first = world.collection<Tag<0U>>();
+	auto& second = world.collection<Tag<1U>>();
+	auto& third = world.collection<Tag<2U>>();
+	auto probed = bench::best(RUNS, [&]() {
+		for (auto& entity : entities) {
+			matches += first.contains(entity.id()) && second.contains(entity.id()) && third.contains(entity.id());
+		}
+	});
+
+	bench::report("has<A, B, C>, signature mask", masked * 1000000.0 / ENTITIES, "ns");
+	bench::report("has<A, B, C>, sparse lookups", probed * 1000000.0 / ENTITIES, "ns");
+	bench::keep(matches);
+}
@@ -0,0 +1,60 @@
+#include "Benchmark.h"
+
+#include <Engine/Messages/MessageManager.hpp>
+#include <Engine/Entities/Entity/Entity.hpp>
+#include <Engine/Entities/Entity/EntityManager.hpp>
+
+namespace
+{
+	template <unsigned>
+	struct Value
+	{
+		float value = 1.f;
+	};
+
+	using A = Value<0U>;
+	using B = Value<1U>;
+	using C = Value<2U>;
+	using D = Value<3U>;
+	using E = Value<4U>;
+}
+
+// Eight systems iterating small views every frame, the cost of building and walking the views dominating
+BENCHMARK(SmallViews)
+{
+	const auto FRAMES = 100000U;
+
+	auto messages = std::make_shared<mqs::MessageManager>();
+	auto world = ecs::EntityManager(messages);
+	world.create(100U, A(), B(), C(), D());
+	world.create(100U, A(), C(), E());
+
+	auto sum = 0.f;
+	auto visit = [&](auto&, auto&... components) {
+		sum += (0.f + ... + components.value);
+	};
+
+	auto frame = [&]() {
+		world.each<A, B>(visit);
+		world.each<A, C>(visit);
+		world.each<B, C, D>(visit);
+		world.each<A, E>(visit);
+		world.each<C, E>(visit);
+		world.each<A, B, C, D>(visit);
+		world.each<A, C, E>(visit);
+		world.each<D, B>(visit);
+	};
+
+	frame(); // Lets the world allocate whatever it caches
+
+	auto before = bench::allocations();
+	auto elapsed = bench::best(5U, [&]() {
+		for (auto index = 0U; index < FRAMES; ++index) {
+			frame();
+		}
+	});
+
+	bench::report("8 views over 200 entities, per frame", elapsed * 1000.0 / FRAMES, "us");
+	bench::report("allocations per frame", double(bench::allocations() - before) / (5U * FRAMES), "");
+	bench::keep(sum);
+}
@@ -0,0 +1,104 @@
+#include "Benchmark.h"
+
+#include <memory>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Engine/Entities/Entity/CountingResource.hpp>
+#include <Engine/Entities/Component/ComponentCollection.hpp>
+
+namespace
+{
+	const auto HIGHEST = ecs::EntityId(0xFFFFFFU); // Highest index of 32-bit identifiers, whatever the width of the build
+
+	// Flat sparse array the collections used before paging, one slot per index up to the highest one
+	class FlatIndex final
+	{
+	public:
+		explicit FlatIndex(std::pmr::memory_resource* resource) : values(resource), indices(resource) {}
+
+		void add(ecs::EntityId item) {
+			auto key = item & ecs::Entity::ID_MASK;
+
+			if (key >= indices.size()) {
+				indices.resize(key + 1U);
+			}
+
+			indices[key] = ecs::EntityId(values.size()) | ecs::EntityTraits<>::OCCUPIED;
+			values.push_back(item);
+		}
+
+		bool contains(ecs::EntityId item) const {
+			auto key = item & ecs::Entity::ID_MASK;
+
+			if (key >= indices.size()) return false;
+
+			auto entry = indices[key];
+			return (entry & ecs::EntityTraits<>::OCCUPIED) != 0U && values[unsigned(entry & ~ecs::EntityTraits<>::OCCUPIED)] == item;
+		}
+
+	private:
+		std::pmr::vector<ecs::EntityId> values;
+		std::pmr::vector<ecs::EntityId> indices;
+	};
+
+	// Collections holding a few low indices and a few indices next to the highest one
+	template <typename Index>
+	std::size_t footprint(unsigned collections) {
+		auto resource = ecs::CountingResource();
+		auto indices = std::vector<std::unique_ptr<Index>>();
+
+		for (auto collection = 0U; collection < collections; ++collection) {
+			indices.push_back(std::make_unique<Index>(&resource));
+
+			for (auto item = ecs::EntityId(0U); item < 16U; ++item) {
+				indices.back()->add(item);
+				indices.back()->add(HIGHEST - item);
+			}
+		}
+
+		return resource.bytes();
+	}
+
+	// Mean duration of a lookup of a random item, half of them being absent
+	template <typename Index>
+	double latency(unsigned items) {
+		auto index = Index(std::pmr::get_default_resource());
+		auto random = std::mt19937(42U);
+		auto spread = std::uniform_int_distribution<ecs::EntityId>(0U, HIGHEST);
+		auto probes = std::vector<ecs::EntityId>();
+
+		for (auto item = 0U; item < items; ++item) {
+			auto id = spread(random);
+			index.add(id);
+			probes.push_back(id);
+			probes.push_back(spread(random));
+		}
+
+		std::shuffle(probes.begin(), probes.end(), random);
+
+		auto found = 0U;
+		auto elapsed = bench::best(10U, [&]() {
+			for (auto probe : probes) {
+				found += index.contains(probe);
+			}
+		});
+
+		bench::keep(found);
+		return elapsed * 1000000.0 / probes.size();
+	}
+}
+
+// Memory held by the sparse indices of collections with far apart items, and the cost of a lookup
+BENCHMARK(SparseIndex)
+{
+	bench::report("flat index, 16 collections, 32 items each", footprint<FlatIndex>(16U) / 1024.0, "KB");
+	bench::report("paged index, 16 collections, 32 items each", footprint<ecs::Collection>(16U) / 1024.0, "KB");
+
+	for (auto items : { 1U << 12U, 1U << 16U, 1U << 20U }) {
+		bench::report(("flat contains, " + std::to_string(items) + " random items").c_str(), latency<FlatIndex>(items), "ns");
+		bench::report(("paged contains, " + std::to_string(items) + " random items").c_str(), latency<ecs::Collection>(items), "ns");
+	}
+}
@@ -0,0 +1,110 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <Engine/Entities/Component/ComponentStorage.hpp>
+
+namespace
+{
+	template <unsigned>
+	struct Vector
+	{
+		float x = 0.f;
+		float y = 0.f;
+	};
+
+	using Position = Vector<0U>;
+	using Velocity = Vector<1U>;
+	using MappedPosition = Vector<2U>;
+	using MappedVelocity = Vector<3U>;
+}
+
+template <>
+struct ecs::ComponentStorage<MappedPosition>
+{
+	using type = ecs::MappedStorage<MappedPosition>;
+};
+
+template <>
+struct ecs::ComponentStorage<MappedVelocity>
+{
+	using type = ecs::MappedStorage<MappedVelocity>;
+};
+
+#include <Engine/Messages/MessageManager.hpp>
+#include <Engine/Entities/Entity/Entity.hpp>
+#include <Engine/Entities/Entity/EntityManager.hpp>
+
+namespace
+{
+	const auto ENTITIES = 1000000U;
+	const auto RUNS = 5U;
+
+	// Builds a world entity by entity, as levels used to be loaded, listeners being notified of every addition
+	template <typename First, typename Second>
+	void populate(ecs::EntityManager& world) {
+		for (auto index = 0U; index < ENTITIES; ++index) {
+			auto entity = world.create();
+			world.assign(entity.id(), First { float(index), 0.f });
+			world.assign(entity.id(), Second { 1.f, 1.f });
+		}
+	}
+
+	template <typename First, typename Second, typename Load>
+	double startup(const std::shared_ptr<mqs::MessageManager>& messages, Load&& load) {
+		return bench::best(RUNS, [&]() {
+			auto world = ecs::EntityManager(messages);
+			world.prepare<First, Second>();
+			load(world);
+
+			auto sum = 0.0;
+			world.each<First, Second>([&](auto&, auto& first, auto& second) {
+				sum += first.x + second.y; // Touches every component, paging the mapped ones in
+			});
+
+			bench::keep(sum);
+		});
+	}
+}
+
+// Startup of a 1M entities world with two components each: replaying additions, restoring a snapshot and loading it mapped
+BENCHMARK(Startup)
+{
+	const char* path = "Startup.snapshot";
+
+	auto messages = std::make_shared<mqs::MessageManager>();
+	auto listener = messages->on<ComponentAdded<Position>>([](const mqs::Message&) {});
+	auto loaded = messages->on<WorldLoaded>([](const mqs::Message&) {});
+
+	bench::report("create and assign", startup<Position, Velocity>(messages, populate<Position, Velocity>), "ms");
+
+	{
+		auto world = ecs::EntityManager(messages);
+		populate<Position, Velocity>(world);
+		auto file = std::ofstream(path, std::ios::binary);
+		world.snapshot(file);
+	}
+
+	bench::report("restore from a file stream", startup<Position, Velocity>(messages, [&](ecs::EntityManager& world) {
+		auto file = std::ifstream(path, std::ios::binary);
+		world.restore(file);
+	}), "ms");
+
+	bench::report("load, vector storage", startup<Position, Velocity>(messages, [&](ecs::EntityManager& world) {
+		world.load(path);
+	}), "ms");
+
+	{
+		auto world = ecs::EntityManager(messages);
+		populate<MappedPosition, MappedVelocity>(world);
+		auto file = std::ofstream(path, std::ios::binary);
+		world.snapshot(file);
+	}
+
+	bench::report("load, mapped storage", startup<MappedPosition, MappedVelocity>(messages, [&](ecs::EntityManager& world) {
+		world.load(path);
+	}), "ms");
+
+	std::remove(path);
+}
@@ -0,0 +1,188 @@
+#ifndef ENTITIES_ARCHETYPE_IMPL
+#define ENTITIES_ARCHETYPE_IMPL
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include "../../Family.hpp"
+#include "../../Messages/MessageManager.hpp"
+#include "../Entity/Entity.h"
+#include "../Component/Message/ComponentRemoved.hpp"
+#include "../Component/Message/ComponentsRemoved.hpp"
+
+namespace ecs
+{
+	/**
+	* @brief Type erased array of components of a single type (a column of an archetype).
+	*
+	* Every component also records the tick of the world clock at which it was added and
+	* last changed, which follow it as it moves between archetypes.
+	*/
+	class Column
+	{
+	public:
+		virtual ~Column() = default;
+
+		// Creates an empty column of the same component type
+		virtual std::unique_ptr<Column> clone() const = 0;
+
+		// Appends the component found at the given row of another column of the same type
+		virtual void move(Column& source, unsigned row) = 0;
+
+		// Removes the component at the given row, moving the last one in its place
+		virtual void erase(unsigned row) = 0;
+
+		// Removes every component, publishing a single ComponentsRemoved for the entities of the rows
+		virtual void clear(mqs::MessageManager& messages, const std::vector<EntityId>& entities) = 0;
+
+		// Publishes the removal of the component at the given row
+		virtual void release(mqs::MessageManager& messages, unsigned row, EntityId entity) = 0;
+
+		virtual void reserve(unsigned capacity) = 0;
+
+		unsigned addedAt(unsigned row) const {
+			return additions[row];
+		}
+
+		unsigned changedAt(unsigned row) const {
+			return changes[row];
+		}
+
+		// Marks the component at the given row as changed at the given tick
+		void touch(unsigned row, unsigned tick) {
+			changes[row] = tick;
+		}
+
+	protected:
+		std::vector<unsigned> additions; // Tick at which each component was added
+		std::vector<unsigned> changes; // Tick at which each component was last changed
+	};
+
+	template <typename Component>
+	class ComponentColumn final : public Column
+	{
+	public:
+		std::unique_ptr<Column> clone() const override {
+			return std::make_unique<ComponentColumn<Component>>();
+		}
+
+		// Appends a component added at the given tick
+		void push(const Component& component, unsigned tick) {
+			components.push_back(component);
+			additions.push_back(tick);
+			changes.push_back(tick);
+		}
+
+		void move(Column& source, unsigned row) override {
+			auto& column = static_cast<ComponentColumn<Component>&>(source);
+
+			components.push_back(std::move(column.components[row]));
+			additions.push_back(column.additions[row]);
+			changes.push_back(column.changes[row]);
+		}
+
+		void erase(unsigned row) override {
+			if (row + 1U != components.size()) {
+				components[row] = std::move(components.back());
+				additions[row] = additions.back();
+				changes[row] = changes.back();
+			}
+
+			components.pop_back();
+			additions.pop_back();
+			changes.pop_back();
+		}
+
+		void clear(mqs::MessageManager& messages, const std::vector<EntityId>& entities) override {
+			if (!components.empty() && messages.listened<ComponentsRemoved<Component>>()) {
+				messages.publish<ComponentsRemoved<Component>>(entities, components);
+			}
+
+			components.clear();
+			additions.clear();
+			changes.clear();
+		}
+
+		void release(mqs::MessageManager& messages, unsigned row, EntityId entity) override {
+			messages.publish<ComponentRemoved<Component>>(components[row], entity);
+		}
+
+		void reserve(unsigned capacity) override {
+			components.reserve(capacity);
+			additions.reserve(capacity);
+			changes.reserve(capacity);
+		}
+
+	public:
+		std::vector<Component> components;
+	};
+
+	/**
+	* @brief Entities sharing the exact same set of component types.
+	*
+	* Components are stored in one column per type (structure of arrays), where the
+	* components of the entity at a given row are found at that same row in every column.
+	* Transitions to the archetypes with one more or one less component are cached.
+	*/
+	class Archetype final
+	{
+	public:
+		explicit Archetype(const std::vector<unsigned>& signature, std::vector<std::unique_ptr<Column>> columns)
+			: signature(signature)
+			, columns(std::move(columns))
+		{
+			for (auto index = 0U; index < signature.size(); ++index) {
+				if (signature[index] >= lookup.size()) {
+					lookup.resize(signature[index] + 1U, -1);
+				}
+
+				lookup[signature[index]] = index;
+			}
+		}
+
+		Archetype(const Archetype&) = delete;
+
+		// Index of the column storing the given component type, or -1 when there is none
+		int column(unsigned uid) const {
+			return uid < lookup.size() ? lookup[uid] : -1;
+		}
+
+		// Column storing the given component type, which the archetype must have
+		template <typename Component>
+		ComponentColumn<Component>& store() {
+			auto index = column(ComponentFamily::uid<Component>());
+			return static_cast<ComponentColumn<Component>&>(*columns[index]);
+		}
+
+		template <typename Component>
+		std::vector<Component>& components() {
+			return store<Component>().components;
+		}
+
+		unsigned size() const {
+			return entities.size();
+		}
+
+		// Removes every row, publishing a single ComponentsRemoved per column
+		void clear(mqs::MessageManager& messages) {
+			for (auto& column : columns) {
+				column->clear(messages, entities);
+			}
+
+			entities.clear();
+		}
+
+	public:
+		const std::vector<unsigned> signature; // Sorted component identifiers
+		std::vector<std::unique_ptr<Column>> columns; // One per component identifier, in the signature order
+		std::vector<EntityId> entities; // Entity identifier of each row
+		std::unordered_map<unsigned, Archetype*> additions; // Archetype reached by adding a component
+		std::unordered_map<unsigned, Archetype*> removals; // Archetype reached by removing a component
+
+	private:
+		std::vector<int> lookup; // Column index of each component identifier
+	};
+}
+
+#endif
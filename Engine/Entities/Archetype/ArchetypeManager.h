@@ -0,0 +1,253 @@
+#ifndef ECS_ARCHETYPE_MANAGER_DEF
+#define ECS_ARCHETYPE_MANAGER_DEF
+
+#include <map>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include <initializer_list>
+
+#include "Archetype.hpp"
+#include "../Entity/Entity.h"
+#include "../Component/Span.hpp"
+#include "../Component/ComponentFilter.hpp"
+#include "../../Threads/ThreadPool.hpp"
+#include "../Component/Message/ComponentAdded.hpp"
+#include "../Component/Message/ComponentsAdded.hpp"
+#include "../Component/Message/EntityAdded.hpp"
+#include "../Component/Message/EntitiesAdded.hpp"
+#include "../Component/Message/EntityRemoved.hpp"
+#include "../Component/Message/EntitiesRemoved.hpp"
+
+namespace ecs
+{
+	/**
+	* @brief Archetype based alternative to the sparse set based `EntityManager`.
+	*
+	* Entities with identical component types are stored together (see `Archetype`), so
+	* multi-component iterations walk aligned columns of the matching archetypes only, at
+	* the expense of moving an entity's components whenever a component is assigned or
+	* removed. The API mirrors `EntityManager`, including query filters, exclusions,
+	* parallel and chunked iterations, change ticks and contexts, so both can back the
+	* systems (see `WorldTraits`). Sparse set specific features (collections, groups, sorting,
+	* command buffers, snapshots and memory resources) are not provided, hence structural
+	* changes can't be deferred. As with `EntityManager`, structural changes during
+	* iterations are unsafe.
+	*
+	* Chunked iterations hand one run per matching archetype (split by the chunk size when
+	* parallel), as the columns of an archetype line up row by row.
+	*/
+	class ArchetypeManager final
+	{
+	public:
+		using Entity = BasicEntity<ArchetypeManager>;
+
+		// Parallel iterations and systems run on the given workers (the pool shared by default across worlds)
+		ArchetypeManager(const std::shared_ptr<mqs::MessageManager>& messages, const std::shared_ptr<ths::ThreadPool>& workers = ths::ThreadPool::shared());
+		ArchetypeManager(const ArchetypeManager&) = delete;
+		ArchetypeManager(ArchetypeManager&&) = delete; // Entities point to their manager
+
+		ArchetypeManager& operator=(const ArchetypeManager&) = delete;
+		ArchetypeManager& operator=(ArchetypeManager&&) = delete;
+
+		Entity create();
+
+		template <typename Component, typename... Args>
+		Entity create(Args&&... componentArgs);
+
+		template <typename Component, typename... Components, typename = std::enable_if_t<!std::is_integral<Component>::value>>
+		Entity create(const Component& component, const Components&... components);
+
+		template <typename... Components>
+		std::vector<Entity> create(unsigned count, const Components&... components);
+
+		template <typename Component, typename... Args>
+		Component assign(EntityId entityId, Args&&... componentArgs);
+
+		template <typename Component, typename... Args>
+		Component replace(EntityId entityId, Args&&... componentArgs);
+
+		template <typename Component, typename... Args>
+		Component save(EntityId entityId, Args&&... componentArgs);
+
+		template <typename Component>
+		Component& component(EntityId entityId);
+
+		// Applies the function to the component in place and marks it as changed
+		template <typename Component, typename Function>
+		void patch(EntityId entityId, Function&& function);
+
+		// Marks the component as changed, as writes through references are not tracked
+		template <typename Component>
+		void touch(EntityId entityId);
+
+		template <typename Component, typename... Components>
+		void assign(EntityId entityId, const Component& component, const Components&... components);
+
+		template <typename Component, typename... Components>
+		void replace(EntityId entityId, const Component& component, const Components&... components);
+
+		template <typename Component, typename... Components>
+		void save(EntityId entityId, const Component& component, const Components&... components);
+
+		template <typename Component, typename... Components>
+		void reset(EntityId entityId);
+
+		template <typename Component, typename... Components>
+		void reset(EntityId entityId, const Component&, const Components&...);
+
+		template <typename Component, typename... Components>
+		void reset();
+
+		template <typename Component, typename... Components>
+		void remove(EntityId entityId);
+
+		template <typename Component, typename... Components>
+		void remove(EntityId entityId, const Component&, const Components&...);
+
+		template <typename Component, typename... Components>
+		bool has(EntityId entityId);
+
+		// Components may be wrapped in query filters, e.g. each<Changed<Transform>, Body>(...)
+		template <typename Component, typename... Components, typename Lambda>
+		void each(Lambda&& lambda);
+
+		// Skips the archetypes having any of the excluded components, e.g. each<Motion>(exclude<Joystick>, ...)
+		template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+		void each(Exclude<Excluded...>, Lambda&& lambda);
+
+		template <typename Lambda>
+		void each(Lambda&& lambda);
+
+		// Same contract as `EntityManager::parallelEach`, the rows of each archetype being split into chunks
+		template <typename Component, typename... Components, typename Lambda>
+		void parallelEach(Lambda&& lambda, unsigned chunk = 0U);
+
+		template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+		void parallelEach(Exclude<Excluded...>, Lambda&& lambda, unsigned chunk = 0U);
+
+		// Visits the entities as spans over the columns of each matching archetype, as `EntityManager::eachChunk`
+		template <typename Component, typename... Components, typename Lambda>
+		void eachChunk(Lambda&& lambda);
+
+		template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+		void eachChunk(Exclude<Excluded...>, Lambda&& lambda);
+
+		template <typename Component, typename... Components, typename Lambda>
+		void parallelEachChunk(Lambda&& lambda, unsigned chunk = 0U);
+
+		template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+		void parallelEachChunk(Exclude<Excluded...>, Lambda&& lambda, unsigned chunk = 0U);
+
+		template <typename Component>
+		unsigned count();
+
+		// Creates the empty columns of the components, so they are not lazily created concurrently
+		template <typename... Components>
+		void prepare();
+
+		// Structural changes are applied immediately, hence there is nothing to play back
+		void flush();
+
+		// World-wide singleton of the given type, default constructed on first access (see `EntityManager::context`)
+		template <typename Context>
+		Context& context();
+
+		unsigned size() const;
+
+		ths::ThreadPool& workers() const;
+
+		// Current tick of the world clock, recorded by components as they are added or changed
+		unsigned tick() const;
+
+		// Starts a new tick and returns it
+		unsigned advance();
+
+		// Sets the tick after which filters report changes on the calling thread, returning the previous one
+		unsigned observe(unsigned since);
+
+		EntityId version(EntityId entityId) const;
+		EntityId current(EntityId entityId) const;
+
+		bool valid(EntityId entityId) const;
+
+		void destroy(EntityId entityId);
+
+		// Destroys every entity having all the components, publishing a single ComponentsRemoved per column and EntitiesRemoved
+		template <typename Component, typename... Components>
+		void destroyAll();
+
+		// Destroys every entity, publishing a single ComponentsRemoved per column and EntitiesRemoved
+		void clear();
+
+	private:
+		// Location of an entity's components
+		struct Record final
+		{
+			Archetype* archetype;
+			unsigned row;
+		};
+
+		template <typename Component>
+		bool insert(EntityId entityId, const Component& component);
+
+		template <typename Component>
+		bool erase(EntityId entityId);
+
+		template <typename Component>
+		unsigned enroll();
+
+		template <typename... Components>
+		void preallocate(TypeList<Components...>);
+
+		template <typename Context>
+		void allocateContext();
+
+		template <typename... Contexts>
+		void preallocateContexts(TypeList<Contexts...>);
+
+		// Checks whether the archetype has all the components and none of the excluded ones
+		template <typename... Components>
+		static bool matches(const Archetype& archetype, std::initializer_list<unsigned> excluded);
+
+		// Visits the rows of the matching archetypes accepted by the queries, on the workers if any
+		template <typename... Queries, typename Lambda>
+		void filter(Lambda& lambda, ths::ThreadPool* workers, unsigned chunk, std::initializer_list<unsigned> excluded);
+
+		// Hands the rows of the matching archetypes as spans, on the workers if any
+		template <typename... Components, typename Lambda>
+		void spans(Lambda& lambda, ths::ThreadPool* workers, unsigned chunk, std::initializer_list<unsigned> excluded);
+
+		static unsigned& observed();
+
+		Archetype& transition(Archetype& source, unsigned uid, bool adding);
+
+		void move(EntityId entityId, Archetype& source, Archetype& target);
+
+		void erase(Archetype& archetype, unsigned row);
+
+		// Releases the identifier of a destroyed entity, whose components are dropped by the caller
+		void recycle(EntityId entityId);
+
+		EntityId generate();
+
+		void validate(EntityId entityId);
+
+	private:
+		EntityId next = 0U;
+		unsigned available = 0U;
+		std::vector<EntityId> entities;
+		std::vector<Record> records; // Indexed as the entities
+		std::vector<std::unique_ptr<Column>> prototypes; // Empty column of each known component identifier
+		std::map<std::vector<unsigned>, std::unique_ptr<Archetype>> archetypes; // By signature
+		std::vector<Archetype*> ordered; // Archetypes in creation order, for iterations
+		Archetype* root;
+		std::vector<std::shared_ptr<void>> contexts; // Indexed by context identifier, kept as the world is cleared
+		std::shared_ptr<mqs::MessageManager> messages;
+		std::shared_ptr<ths::ThreadPool> pool;
+		std::atomic<unsigned> clock { 1U }; // Starts at one, so that filters report everything to systems never run
+	};
+}
+
+#endif
@@ -0,0 +1,637 @@
+#ifndef ECS_ARCHETYPE_MANAGER_IMPL
+#define ECS_ARCHETYPE_MANAGER_IMPL
+
+#include <tuple>
+#include <cassert>
+#include <algorithm>
+
+#include "ArchetypeManager.h"
+#include "../Entity/Entity.hpp"
+
+namespace ecs
+{
+	inline ArchetypeManager::ArchetypeManager(const std::shared_ptr<mqs::MessageManager>& messages, const std::shared_ptr<ths::ThreadPool>& workers) : messages(messages), pool(workers) {
+		auto& empty = archetypes[std::vector<unsigned>()];
+		empty = std::make_unique<Archetype>(std::vector<unsigned>(), std::vector<std::unique_ptr<Column>>());
+		root = empty.get();
+		ordered.push_back(root);
+
+		// Registered component types get their prototype columns upfront, and registered contexts are constructed
+		preallocate(Registry<ComponentFamily>::types());
+		contexts.reserve(Registry<ContextFamily>::types::size);
+		preallocateContexts(Registry<ContextFamily>::types());
+	}
+
+	inline ArchetypeManager::Entity ArchetypeManager::create() {
+		auto id = generate();
+
+		root->entities.push_back(id);
+		records[id & Entity::ID_MASK] = { root, root->size() - 1U };
+		messages->publish<EntityAdded>(id);
+
+		return Entity(id, this);
+	}
+
+	template <typename Component, typename... Args>
+	inline ArchetypeManager::Entity ArchetypeManager::create(Args&&... componentArgs) {
+		auto entity = create();
+		assign<Component>(entity.id(), std::forward<Args>(componentArgs)...);
+		return entity;
+	}
+
+	template <typename Component, typename... Components, typename>
+	inline ArchetypeManager::Entity ArchetypeManager::create(const Component& component, const Components&... components) {
+		auto entity = create();
+		assign(entity.id(), component, components...);
+		return entity;
+	}
+
+	template <typename... Components>
+	inline std::vector<ArchetypeManager::Entity> ArchetypeManager::create(unsigned count, const Components&... components) {
+		auto target = root;
+		auto ids = std::vector<EntityId>();
+		auto created = std::vector<Entity>();
+
+		// Every entity lands directly in the final archetype, without intermediate moves
+		auto uids = { 0U, enroll<Components>()... };
+
+		for (auto uid = std::next(uids.begin()); uid != uids.end(); ++uid) {
+			target = &transition(*target, *uid, true);
+		}
+
+		ids.reserve(count);
+		created.reserve(count);
+		target->entities.reserve(target->size() + count);
+
+		for (auto& column : target->columns) {
+			column->reserve(target->size() + count);
+		}
+
+		for (auto index = 0U; index < count; ++index) {
+			auto id = generate();
+			auto pushing = { 0U, (target->template store<Components>().push(components, tick()), 0U)... };
+
+			target->entities.push_back(id);
+			records[id & Entity::ID_MASK] = { target, target->size() - 1U };
+			ids.push_back(id);
+			created.emplace_back(id, this);
+		}
+
+		messages->publish<EntitiesAdded>(ids);
+
+		if (count) {
+			auto publishing = { 0U, (messages->publish<ComponentsAdded<Components>>(ids), 0U)... };
+		}
+
+		return created;
+	}
+
+	template <typename Component, typename... Args>
+	inline Component ArchetypeManager::assign(EntityId entityId, Args&&... componentArgs) {
+		validate(entityId);
+		auto component = Component(std::forward<Args>(componentArgs)...);
+		insert(entityId, component);
+		return component;
+	}
+
+	template <typename Component, typename... Args>
+	inline Component ArchetypeManager::replace(EntityId entityId, Args&&... componentArgs) {
+		auto component = Component(std::forward<Args>(componentArgs)...);
+		replace(entityId, component);
+		return component;
+	}
+
+	template <typename Component, typename... Args>
+	inline Component ArchetypeManager::save(EntityId entityId, Args&&... componentArgs) {
+		auto component = Component(std::forward<Args>(componentArgs)...);
+		save(entityId, component);
+		return component;
+	}
+
+	template <typename Component>
+	inline Component& ArchetypeManager::component(EntityId entityId) {
+		validate(entityId);
+		auto& record = records[entityId & Entity::ID_MASK];
+		assert(record.archetype->column(ComponentFamily::uid<Component>()) >= 0);
+		return record.archetype->template components<Component>()[record.row];
+	}
+
+	template <typename Component, typename Function>
+	inline void ArchetypeManager::patch(EntityId entityId, Function&& function) {
+		function(component<Component>(entityId));
+		touch<Component>(entityId);
+	}
+
+	template <typename Component>
+	inline void ArchetypeManager::touch(EntityId entityId) {
+		validate(entityId);
+		auto& record = records[entityId & Entity::ID_MASK];
+		record.archetype->template store<Component>().touch(record.row, tick());
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::assign(EntityId entityId, const Component& component, const Components&... components) {
+		validate(entityId);
+		insert(entityId, component);
+		auto assigning = { 0U, (insert(entityId, components), 0U)... };
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::replace(EntityId entityId, const Component& component, const Components&... components) {
+		validate(entityId);
+
+		if (has<Component>(entityId)) {
+			auto& replaced = this->template component<Component>(entityId);
+			auto old = replaced;
+			messages->publish<ComponentRemoved<Component>>(old, entityId);
+			replaced = component;
+			touch<Component>(entityId);
+			messages->publish<ComponentAdded<Component>>(component, entityId);
+		}
+
+		auto replacing = { 0U, (replace(entityId, components), 0U)... };
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::save(EntityId entityId, const Component& component, const Components&... components) {
+		validate(entityId);
+
+		if (has<Component>(entityId)) {
+			replace(entityId, component);
+		}
+		else {
+			insert(entityId, component);
+		}
+
+		auto saving = { 0U, (save(entityId, components), 0U)... };
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::reset(EntityId entityId) {
+		remove<Component, Components...>(entityId);
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::reset(EntityId entityId, const Component&, const Components&...) {
+		reset<Component, Components...>(entityId);
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::reset() {
+		auto uids = { ComponentFamily::uid<Component>(), ComponentFamily::uid<Components>()... };
+		auto owners = std::vector<EntityId>();
+
+		// Removals move rows around, hence the owners are collected first
+		for (auto archetype : ordered) {
+			auto owning = std::any_of(uids.begin(), uids.end(), [archetype](unsigned uid) { return archetype->column(uid) >= 0; });
+
+			if (owning) {
+				owners.insert(owners.end(), archetype->entities.begin(), archetype->entities.end());
+			}
+		}
+
+		for (auto entityId : owners) {
+			remove<Component, Components...>(entityId);
+		}
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::remove(EntityId entityId) {
+		validate(entityId);
+		erase<Component>(entityId);
+		auto removing = { 0U, (erase<Components>(entityId), 0U)... };
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::remove(EntityId entityId, const Component&, const Components&...) {
+		remove<Component, Components...>(entityId);
+	}
+
+	template <typename Component, typename... Components>
+	inline bool ArchetypeManager::has(EntityId entityId) {
+		validate(entityId);
+		auto archetype = records[entityId & Entity::ID_MASK].archetype;
+		auto uids = { ComponentFamily::uid<Component>(), ComponentFamily::uid<Components>()... };
+		return std::all_of(uids.begin(), uids.end(), [archetype](unsigned uid) { return archetype->column(uid) >= 0; });
+	}
+
+	template <typename Component, typename... Components, typename Lambda>
+	inline void ArchetypeManager::each(Lambda&& lambda) {
+		filter<Component, Components...>(lambda, nullptr, 0U, {});
+	}
+
+	template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+	inline void ArchetypeManager::each(Exclude<Excluded...>, Lambda&& lambda) {
+		filter<Component, Components...>(lambda, nullptr, 0U, { ComponentFamily::uid<Excluded>()... });
+	}
+
+	template <typename Lambda>
+	inline void ArchetypeManager::each(Lambda&& lambda) {
+		for (auto index = 0U; index < entities.size(); ++index) {
+			if ((entities[index] & Entity::ID_MASK) == index) { // Released slots hold the next available one
+				auto entity = Entity(entities[index], this);
+				lambda(entity);
+			}
+		}
+	}
+
+	template <typename Component, typename... Components, typename Lambda>
+	inline void ArchetypeManager::parallelEach(Lambda&& lambda, unsigned chunk) {
+		filter<Component, Components...>(lambda, pool.get(), chunk, {});
+	}
+
+	template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+	inline void ArchetypeManager::parallelEach(Exclude<Excluded...>, Lambda&& lambda, unsigned chunk) {
+		filter<Component, Components...>(lambda, pool.get(), chunk, { ComponentFamily::uid<Excluded>()... });
+	}
+
+	template <typename Component, typename... Components, typename Lambda>
+	inline void ArchetypeManager::eachChunk(Lambda&& lambda) {
+		spans<Component, Components...>(lambda, nullptr, 0U, {});
+	}
+
+	template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+	inline void ArchetypeManager::eachChunk(Exclude<Excluded...>, Lambda&& lambda) {
+		spans<Component, Components...>(lambda, nullptr, 0U, { ComponentFamily::uid<Excluded>()... });
+	}
+
+	template <typename Component, typename... Components, typename Lambda>
+	inline void ArchetypeManager::parallelEachChunk(Lambda&& lambda, unsigned chunk) {
+		spans<Component, Components...>(lambda, pool.get(), chunk, {});
+	}
+
+	template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+	inline void ArchetypeManager::parallelEachChunk(Exclude<Excluded...>, Lambda&& lambda, unsigned chunk) {
+		spans<Component, Components...>(lambda, pool.get(), chunk, { ComponentFamily::uid<Excluded>()... });
+	}
+
+	template <typename Component>
+	inline unsigned ArchetypeManager::count() {
+		auto uid = ComponentFamily::uid<Component>();
+		auto total = 0U;
+
+		for (auto archetype : ordered) {
+			total += archetype->column(uid) >= 0 ? archetype->size() : 0U;
+		}
+
+		return total;
+	}
+
+	template <typename... Components>
+	inline void ArchetypeManager::prepare() {
+		auto preparing = { 0U, enroll<Components>()... };
+	}
+
+	inline void ArchetypeManager::flush() {
+		// Nothing is deferred
+	}
+
+	template <typename Context>
+	inline Context& ArchetypeManager::context() {
+		if constexpr (!ContextFamily::registered<Context>()) {
+			allocateContext<Context>(); // Registered ones are allocated on construction
+		}
+
+		return *static_cast<Context*>(contexts[ContextFamily::uid<Context>()].get());
+	}
+
+	inline unsigned ArchetypeManager::size() const {
+		return entities.size() - available;
+	}
+
+	inline ths::ThreadPool& ArchetypeManager::workers() const {
+		return *pool;
+	}
+
+	inline unsigned ArchetypeManager::tick() const {
+		return clock.load(std::memory_order_relaxed);
+	}
+
+	inline unsigned ArchetypeManager::advance() {
+		return clock.fetch_add(1U, std::memory_order_relaxed) + 1U;
+	}
+
+	inline unsigned ArchetypeManager::observe(unsigned since) {
+		auto previous = observed();
+		observed() = since;
+		return previous;
+	}
+
+	inline EntityId ArchetypeManager::version(EntityId entityId) const {
+		return EntityId((entityId >> Entity::VERSION_SHIFT) & Entity::VERSION_MASK);
+	}
+
+	inline EntityId ArchetypeManager::current(EntityId entityId) const {
+		auto index = entityId & Entity::ID_MASK;
+		assert(index < entities.size());
+		return EntityId((entities[index] >> Entity::VERSION_SHIFT) & Entity::VERSION_MASK);
+	}
+
+	inline bool ArchetypeManager::valid(EntityId entityId) const {
+		auto index = entityId & Entity::ID_MASK;
+		return index < entities.size() && entities[index] == entityId;
+	}
+
+	inline void ArchetypeManager::destroy(EntityId entityId) {
+		validate(entityId);
+
+		auto record = records[entityId & Entity::ID_MASK];
+
+		recycle(entityId);
+
+		for (auto& column : record.archetype->columns) {
+			column->release(*messages, record.row, entityId);
+		}
+
+		erase(*record.archetype, record.row);
+		messages->publish<EntityRemoved>(entityId);
+	}
+
+	template <typename Component, typename... Components>
+	inline void ArchetypeManager::destroyAll() {
+		auto destroyed = std::vector<EntityId>();
+
+		// Matching archetypes are emptied at once, column by column (handlers may create archetypes, hence no iterators)
+		for (auto index = 0U; index < ordered.size(); ++index) {
+			auto archetype = ordered[index];
+
+			if (matches<Component, Components...>(*archetype, {})) {
+				for (auto entityId : archetype->entities) {
+					recycle(entityId);
+				}
+
+				destroyed.insert(destroyed.end(), archetype->entities.begin(), archetype->entities.end());
+				archetype->clear(*messages);
+			}
+		}
+
+		if (!destroyed.empty()) {
+			messages->publish<EntitiesRemoved>(destroyed);
+		}
+	}
+
+	inline void ArchetypeManager::clear() {
+		auto destroyed = std::vector<EntityId>();
+		auto listened = messages->listened<EntitiesRemoved>();
+
+		// Every live entity is in an archetype, if only the empty one (handlers may create archetypes, hence no iterators)
+		for (auto index = 0U; index < ordered.size(); ++index) {
+			auto archetype = ordered[index];
+
+			for (auto entityId : archetype->entities) {
+				recycle(entityId);
+			}
+
+			if (listened) {
+				destroyed.insert(destroyed.end(), archetype->entities.begin(), archetype->entities.end());
+			}
+
+			archetype->clear(*messages);
+		}
+
+		if (!destroyed.empty()) {
+			messages->publish<EntitiesRemoved>(destroyed);
+		}
+	}
+
+	template <typename Component>
+	inline bool ArchetypeManager::insert(EntityId entityId, const Component& component) {
+		auto uid = enroll<Component>();
+		auto& record = records[entityId & Entity::ID_MASK];
+		auto& source = *record.archetype;
+
+		if (source.column(uid) >= 0) {
+			return false;
+		}
+
+		auto& target = transition(source, uid, true);
+
+		move(entityId, source, target);
+		target.template store<Component>().push(component, tick());
+		messages->publish<ComponentAdded<Component>>(component, entityId);
+
+		return true;
+	}
+
+	template <typename Component>
+	inline bool ArchetypeManager::erase(EntityId entityId) {
+		auto uid = ComponentFamily::uid<Component>();
+		auto& record = records[entityId & Entity::ID_MASK];
+		auto& source = *record.archetype;
+
+		if (source.column(uid) < 0) {
+			return false;
+		}
+
+		auto component = source.template components<Component>()[record.row];
+
+		move(entityId, source, transition(source, uid, false));
+		messages->publish<ComponentRemoved<Component>>(component, entityId);
+
+		return true;
+	}
+
+	template <typename Component>
+	inline unsigned ArchetypeManager::enroll() {
+		auto uid = ComponentFamily::uid<Component>();
+
+		if (uid >= prototypes.size()) {
+			prototypes.resize(uid + 1U);
+		}
+
+		if (!prototypes[uid]) {
+			prototypes[uid] = std::make_unique<ComponentColumn<Component>>();
+		}
+
+		return uid;
+	}
+
+	template <typename... Components>
+	inline void ArchetypeManager::preallocate(TypeList<Components...>) {
+		auto allocating = { 0U, enroll<Components>()... };
+	}
+
+	template <typename Context>
+	inline void ArchetypeManager::allocateContext() {
+		auto uid = ContextFamily::uid<Context>();
+
+		if (uid >= contexts.size()) {
+			contexts.resize(uid + 1U);
+		}
+
+		if (!contexts[uid]) {
+			contexts[uid] = std::make_shared<Context>();
+		}
+	}
+
+	template <typename... Contexts>
+	inline void ArchetypeManager::preallocateContexts(TypeList<Contexts...>) {
+		auto allocating = { 0U, (allocateContext<Contexts>(), 0U)... };
+	}
+
+	template <typename... Components>
+	inline bool ArchetypeManager::matches(const Archetype& archetype, std::initializer_list<unsigned> excluded) {
+		auto uids = { ComponentFamily::uid<Components>()... };
+		auto having = [&archetype](unsigned uid) { return archetype.column(uid) >= 0; };
+
+		return std::all_of(uids.begin(), uids.end(), having) && std::none_of(excluded.begin(), excluded.end(), having);
+	}
+
+	template <typename... Queries, typename Lambda>
+	inline void ArchetypeManager::filter(Lambda& lambda, ths::ThreadPool* workers, unsigned chunk, std::initializer_list<unsigned> excluded) {
+		auto since = observed(); // Read on the calling thread, as parallel visits run on the workers
+
+		for (auto archetype : ordered) {
+			if (archetype->size() && matches<FilteredComponent<Queries>...>(*archetype, excluded)) {
+				auto columns = std::make_tuple(&archetype->template store<FilteredComponent<Queries>>()...);
+
+				// Columns line up, hence every filter is tested at the same row
+				auto visit = [&](unsigned begin, unsigned end) {
+					for (auto row = begin; row < end; ++row) {
+						if ((... && ComponentFilter<Queries>::admits(*std::get<ComponentColumn<FilteredComponent<Queries>>*>(columns), row, since))) {
+							auto entity = Entity(archetype->entities[row], this);
+							lambda(entity, std::get<ComponentColumn<FilteredComponent<Queries>>*>(columns)->components[row]...);
+						}
+					}
+				};
+
+				if (workers) {
+					workers->chunked(archetype->size(), chunk, visit);
+				}
+				else {
+					visit(0U, archetype->size());
+				}
+			}
+		}
+	}
+
+	template <typename... Components, typename Lambda>
+	inline void ArchetypeManager::spans(Lambda& lambda, ths::ThreadPool* workers, unsigned chunk, std::initializer_list<unsigned> excluded) {
+		static_assert(!filtering<Components...>(), "Filtered queries can't be spanned");
+
+		for (auto archetype : ordered) {
+			if (archetype->size() && matches<Components...>(*archetype, excluded)) {
+				auto visit = [&](unsigned begin, unsigned end) {
+					lambda(Span<const EntityId>(archetype->entities.data() + begin, end - begin), Span<Components>(archetype->template components<Components>().data() + begin, end - begin)...);
+				};
+
+				if (workers) {
+					workers->chunked(archetype->size(), chunk, visit);
+				}
+				else {
+					visit(0U, archetype->size());
+				}
+			}
+		}
+	}
+
+	inline unsigned& ArchetypeManager::observed() {
+		static thread_local unsigned since = 0U; // Everything is reported outside of systems, unless observing
+		return since;
+	}
+
+	inline Archetype& ArchetypeManager::transition(Archetype& source, unsigned uid, bool adding) {
+		auto& edges = adding ? source.additions : source.removals;
+		auto edge = edges.find(uid);
+
+		if (edge != edges.end()) {
+			return *edge->second;
+		}
+
+		auto signature = source.signature;
+
+		if (adding) {
+			signature.insert(std::upper_bound(signature.begin(), signature.end(), uid), uid);
+		}
+		else {
+			signature.erase(std::lower_bound(signature.begin(), signature.end(), uid));
+		}
+
+		auto& target = archetypes[signature];
+
+		if (!target) {
+			auto columns = std::vector<std::unique_ptr<Column>>();
+
+			for (auto component : signature) {
+				columns.push_back(prototypes[component]->clone());
+			}
+
+			target = std::make_unique<Archetype>(signature, std::move(columns));
+			ordered.push_back(target.get());
+		}
+
+		edges[uid] = target.get();
+		(adding ? target->removals : target->additions)[uid] = &source;
+
+		return *target;
+	}
+
+	inline void ArchetypeManager::move(EntityId entityId, Archetype& source, Archetype& target) {
+		auto& record = records[entityId & Entity::ID_MASK];
+		auto row = record.row;
+
+		for (auto index = 0U; index < source.columns.size(); ++index) {
+			auto column = target.column(source.signature[index]);
+
+			if (column >= 0) {
+				target.columns[column]->move(*source.columns[index], row);
+			}
+		}
+
+		target.entities.push_back(entityId);
+		erase(source, row);
+		record = { &target, target.size() - 1U };
+	}
+
+	inline void ArchetypeManager::erase(Archetype& archetype, unsigned row) {
+		for (auto& column : archetype.columns) {
+			column->erase(row);
+		}
+
+		auto last = archetype.entities.back();
+		archetype.entities[row] = last;
+		archetype.entities.pop_back();
+
+		if (row < archetype.size()) {
+			records[last & Entity::ID_MASK].row = row; // The last entity took the erased row
+		}
+	}
+
+	inline void ArchetypeManager::recycle(EntityId entityId) {
+		auto entity = entityId & Entity::ID_MASK;
+		auto version = (entityId & (~Entity::ID_MASK)) + (EntityId(1U) << Entity::VERSION_SHIFT);
+
+		entities[entity] = (available ? next : ((entity + 1U) & Entity::ID_MASK)) | version;
+		records[entity] = { nullptr, 0U };
+		next = entity;
+		available++;
+	}
+
+	inline EntityId ArchetypeManager::generate() {
+		EntityId id = 0U;
+
+		if (available) {
+			auto entity = next;
+			auto version = entities[entity] & ~Entity::ID_MASK;
+
+			id = entity | version;
+			next = entities[entity] & Entity::ID_MASK;
+			entities[entity] = id;
+			available--;
+		}
+		else {
+			id = entities.size();
+			assert(id < Entity::ID_MASK);
+			entities.push_back(id);
+			records.push_back({ nullptr, 0U });
+		}
+
+		return id;
+	}
+
+	inline void ArchetypeManager::validate(EntityId entityId) {
+		if (!valid(entityId)) throw "Invalid entity identifier";
+	}
+}
+
+#endif
@@ -1,25 +1,64 @@
 #ifndef ENTITIES_COMPONENT_COLLECTION_IMPL
 #define ENTITIES_COMPONENT_COLLECTION_IMPL
 
+#include <atomic>
+#include <bitset>
 #include <vector>
-
+#include <memory>
+#include <numeric>
+#include <algorithm>
+#include <memory_resource>
+
+#include "ComponentStorage.hpp"
+#include "SignatureTraits.hpp"
+#include "../Entity/Entity.h"
+#include "ComponentSerialization.hpp"
+#include "ComponentNotifications.hpp"
 #include "../../Messages/MessageManager.hpp"
 #include "../../Entities/Component/Message/ComponentAdded.hpp"
+#include "../../Entities/Component/Message/ComponentsAdded.hpp"
 #include "../../Entities/Component/Message/ComponentRemoved.hpp"
+#include "../../Entities/Component/Message/ComponentsRemoved.hpp"
 
 namespace ecs
 {
+	class ComponentGroup;
+
+	// Component types of an entity, one bit per component identifier (see `Collection::track` and `SignatureTraits`)
+	using Signature = std::bitset<SignatureTraits<>::BITS>;
+
 	/**
 	* @brief Sparse set implementation.
+	*
+	* The sparse array is split into fixed-size pages which are only allocated when
+	* an item falling into their range is added. Empty ranges cost an empty page,
+	* hence a single item with a high identifier no longer forces a huge allocation.
+	* Items are placed by their entity index, their version being checked against the
+	* dense set, so recycled identifiers reuse the same slots.
+	*
+	* Every item also records the tick of the world clock (see `EntityManager::tick`)
+	* at which it was added and last changed (see `touch`).
+	*
+	* A tracked collection also keeps its bit of the signatures of the entities it
+	* contains up to date, whichever way items are added or removed.
+	*
+	* Every array of the collection draws from the memory resource given at construction.
 	*/
 	class Collection
 	{
+		friend class ComponentGroup;
+
 	public:
-		using Item = unsigned;
+		using Item = EntityId;
 		using Index = unsigned;
-		using Iterator = std::vector<Item>::iterator;
+		using Iterator = std::pmr::vector<Item>::iterator;
+
+		// Sorting algorithms, incremental being an insertion sort for items which are nearly sorted already
+		enum class Sorting { Full, Incremental };
 
-		Collection() = default;
+		static const unsigned PAGE_SIZE = 4096U; // Number of indices per sparse page (power of two)
+
+		explicit Collection(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : values(resource), pages(resource), additions(resource), changes(resource) {}
 		Collection(const Collection&) = delete; // No copying
 		Collection(Collection&&) = default;
 		virtual ~Collection() = default;
@@ -29,19 +68,35 @@ namespace ecs
 		}
 		
 		virtual void clear() {
+			Collection::discard();
+		}
+
+		// Empties the collection without publishing anything
+		virtual void discard() {
+			if (signatures) {
+				for (auto item : values) {
+					(*signatures)[item & Entity::ID_MASK].reset(bit);
+				}
+			}
+
 			values.clear();
-			indices.clear();
+			pages.clear();
+			additions.clear();
+			changes.clear();
 		}
 
 		virtual bool add(Item item) {
 			auto exists = contains(item);
 
 			if (!exists) {
-				if (item >= indices.size()) {
-					indices.resize(item + 1U);
-				}
-				indices[item] = values.size() | OCCUPIED;
+				assure(item) = values.size() | OCCUPIED;
 				values.push_back(item);
+				additions.push_back(now());
+				changes.push_back(additions.back());
+
+				if (signatures) {
+					(*signatures)[item & Entity::ID_MASK].set(bit);
+				}
 			}
 
 			return !exists;
@@ -52,26 +107,53 @@ namespace ecs
 
 			if (exists) {
 				auto last = values.back();
-				auto index = indices[item] & ~OCCUPIED;
+				auto index = this->index(item);
 
-				indices[last] = index | OCCUPIED;
-				indices[item] = 0U;
+				slot(last) = index | OCCUPIED;
+				slot(item) = 0U;
 
 				values[index] = last;
 				values.pop_back();
+				additions[index] = additions.back();
+				additions.pop_back();
+				changes[index] = changes.back();
+				changes.pop_back();
+
+				if (signatures) {
+					(*signatures)[item & Entity::ID_MASK].reset(bit);
+				}
 			}
 
 			return exists;
 		}
 
-		virtual bool contains(Item item) const {
-			return item < indices.size() && (indices[item] & OCCUPIED) != 0U;
+		bool contains(Item item) const {
+			auto key = item & Entity::ID_MASK;
+			auto page = key / PAGE_SIZE;
+
+			if (page >= pages.size() || pages[page].empty()) return false;
+
+			auto entry = pages[page][key & (PAGE_SIZE - 1U)];
+			return (entry & OCCUPIED) != 0U && values[Index(entry & ~OCCUPIED)] == item;
 		}
 
 		unsigned size() const {
 			return values.size();
 		}
 
+		// Reserves room for the given amount of additional items, up to the given highest item
+		virtual void reserve(unsigned count, Item highest) {
+			values.reserve(values.size() + count);
+			additions.reserve(additions.size() + count);
+			changes.reserve(changes.size() + count);
+
+			auto page = (highest & Entity::ID_MASK) / PAGE_SIZE;
+
+			if (page >= pages.size()) {
+				pages.resize(page + 1U);
+			}
+		}
+
 		Iterator begin() {
 			return values.begin();
 		}
@@ -80,10 +162,313 @@ namespace ecs
 			return values.end();
 		}
 
+		const Item* data() const {
+			return values.data();
+		}
+
+		// Position of the given item within the dense set (the item must be contained)
+		Index index(Item item) const {
+			auto key = item & Entity::ID_MASK;
+			return Index(pages[key / PAGE_SIZE][key & (PAGE_SIZE - 1U)] & ~OCCUPIED);
+		}
+
+		// Group owning this collection, if any
+		const ComponentGroup* owner() const {
+			return group;
+		}
+
+		// Marks the item as changed at the current tick (the item must be contained)
+		void touch(Item item) {
+			changes[index(item)] = now();
+		}
+
+		// Tick at which the item was added (the item must be contained)
+		unsigned added(Item item) const {
+			return additions[index(item)];
+		}
+
+		// Tick at which the item was last added or changed (the item must be contained)
+		unsigned changed(Item item) const {
+			return changes[index(item)];
+		}
+
+		// Tick at which the value at the given position of the dense set was added
+		unsigned addedAt(Index index) const {
+			return additions[index];
+		}
+
+		// Tick at which the value at the given position of the dense set was last added or changed
+		unsigned changedAt(Index index) const {
+			return changes[index];
+		}
+
+		// Reorders the dense set so that the items also contained by the other collection come first,
+		// in the same order as there (the remaining ones follow in no particular order)
+		void respect(const Collection& other) {
+			if (group) throw "Cannot reorder a collection owned by a group";
+
+			auto position = 0U;
+
+			for (auto item : other.values) {
+				if (contains(item)) {
+					swap(index(item), position++);
+				}
+			}
+		}
+
+		// Publishes the notifications batched since the last call, if any
+		virtual void notify() {}
+
+		// Writes the dense set and its ticks (see `EntityManager::snapshot`)
+		virtual void serialize(std::ostream& stream) {
+			Binary::write(stream, values);
+			Binary::write(stream, additions);
+			Binary::write(stream, changes);
+		}
+
+		// Replaces the content by the one written by 'serialize', rebuilding the sparse set
+		virtual void deserialize(std::istream& stream) {
+			discard();
+			Binary::read(stream, values);
+			Binary::read(stream, additions);
+			Binary::read(stream, changes);
+
+			if (additions.size() != values.size() || changes.size() != values.size()) throw "Corrupted snapshot";
+
+			if (!values.empty()) {
+				auto highest = *std::max_element(values.begin(), values.end(), [](Item left, Item right) {
+					return (left & Entity::ID_MASK) < (right & Entity::ID_MASK);
+				});
+
+				pages.resize((highest & Entity::ID_MASK) / PAGE_SIZE + 1U);
+			}
+
+			for (auto index = 0U; index < values.size(); ++index) {
+				assure(values[index]) = index | OCCUPIED;
+			}
+
+			if (signatures) {
+				for (auto item : values) {
+					(*signatures)[item & Entity::ID_MASK].set(bit);
+				}
+			}
+		}
+
+		// Empty collection of the same type drawing from the same resource, e.g. to deserialize into before adopting
+		virtual std::unique_ptr<Collection> stage() const {
+			return std::make_unique<Collection>(values.get_allocator().resource());
+		}
+
+		// Replaces the content by the one of a staged collection (see `stage`), publishing nothing
+		virtual void adopt(Collection& staged) {
+			discard();
+
+			using std::swap;
+			swap(values, staged.values);
+			swap(pages, staged.pages);
+			swap(additions, staged.additions);
+			swap(changes, staged.changes);
+
+			if (signatures) {
+				for (auto item : values) {
+					(*signatures)[item & Entity::ID_MASK].set(bit);
+				}
+			}
+		}
+
+		// Drops the pending batched notifications (see `notify`), e.g. as they refer to a replaced world
+		virtual void forget() {}
+
+		// Keeps the given bit of the signatures of the entities (indexed by entity, sized by the owner) up to date
+		void track(const std::shared_ptr<std::pmr::vector<Signature>>& signatures, unsigned bit) {
+			this->signatures = signatures;
+			this->bit = bit;
+		}
+
+		// Signatures of the entities, if tracked
+		const std::pmr::vector<Signature>* tracked() const {
+			return signatures.get();
+		}
+
+		// Signature of the entities contained by this collection only
+		Signature mask() const {
+			return Signature().set(bit);
+		}
+
+		// Drives the ticks recorded from now on, which stay at zero without a clock
+		void synchronize(const std::shared_ptr<const std::atomic<unsigned>>& clock) {
+			this->clock = clock;
+		}
+
 	protected:
-		static const int OCCUPIED = 0x01000000;
-		std::vector<Item> values; // Where the actual values are stored (dense set)
-		std::vector<Index> indices; // Where the indices to values are stored (sparse set)
+		// Swaps two items within the dense set, keeping the sparse set up to date
+		virtual void swap(Index left, Index right) {
+			auto leftItem = values[left];
+			auto rightItem = values[right];
+
+			std::swap(values[left], values[right]);
+			std::swap(additions[left], additions[right]);
+			std::swap(changes[left], changes[right]);
+			slot(leftItem) = right | OCCUPIED;
+			slot(rightItem) = left | OCCUPIED;
+		}
+
+		// Moves the value at position 'order[index]' of the dense set to 'index', following the cycles of the permutation
+		void permute(std::vector<Index>& order) {
+			for (auto first = 0U; first < order.size(); ++first) {
+				auto current = first;
+
+				while (order[current] != first) {
+					auto next = order[current];
+
+					swap(current, next);
+					order[current] = current;
+					current = next;
+				}
+
+				order[current] = current;
+			}
+		}
+
+		unsigned now() const {
+			return clock ? clock->load(std::memory_order_relaxed) : 0U;
+		}
+
+		// Sparse slot of the given item (its page must be allocated)
+		Item& slot(Item item) {
+			auto key = item & Entity::ID_MASK;
+			return pages[key / PAGE_SIZE][key & (PAGE_SIZE - 1U)];
+		}
+
+		// Sparse slot of the given item, allocating its page on demand
+		Item& assure(Item item) {
+			auto key = item & Entity::ID_MASK;
+			auto page = key / PAGE_SIZE;
+
+			if (page >= pages.size()) {
+				pages.resize(page + 1U);
+			}
+
+			if (pages[page].empty()) {
+				pages[page].resize(PAGE_SIZE); // Zeroed, thus unoccupied
+			}
+
+			return pages[page][key & (PAGE_SIZE - 1U)];
+		}
+
+	protected:
+		static constexpr Item OCCUPIED = EntityTraits<>::OCCUPIED; // Right above the index bits
+		ComponentGroup* group = nullptr; // Owning group, which keeps its entities packed at the front
+		std::pmr::vector<Item> values; // Where the actual values are stored (dense set)
+		std::pmr::vector<std::pmr::vector<Item>> pages; // Where the indices to values are stored (paged sparse set, pages sharing the resource)
+		std::pmr::vector<unsigned> additions; // Tick at which each value was added
+		std::pmr::vector<unsigned> changes; // Tick at which each value was last changed
+		std::shared_ptr<const std::atomic<unsigned>> clock; // World clock, if any
+		std::shared_ptr<std::pmr::vector<Signature>> signatures; // Signatures of the entities, if tracked
+		unsigned bit = 0U; // Bit of the signatures standing for this collection
+	};
+
+	/**
+	* @brief Owning group of component collections.
+	*
+	* Collections owned by a group keep the entities they all have in common packed at
+	* the front of their dense sets, in the same order. Iterating over those entities is
+	* thus a linear walk over the first `size` elements of every owned collection, with
+	* no membership tests. The packing is maintained incrementally as items are added to
+	* or removed from the owned collections. A collection can be owned by a single group.
+	*/
+	class ComponentGroup final
+	{
+	public:
+		explicit ComponentGroup(const std::vector<Collection*>& collections) : collections(collections) {
+			auto smallest = collections.front();
+
+			for (auto collection : collections) {
+				if (collection->group) throw "Collection already owned by another group";
+				smallest = collection->size() < smallest->size() ? collection : smallest;
+			}
+
+			for (auto collection : collections) {
+				collection->group = this;
+			}
+
+			pack();
+		}
+
+		ComponentGroup(const ComponentGroup&) = delete;
+		ComponentGroup(ComponentGroup&&) = delete;
+
+		~ComponentGroup() {
+			for (auto collection : collections) {
+				collection->group = nullptr;
+			}
+		}
+
+		// Pulls the item into the group if every owned collection contains it
+		void refresh(Collection::Item item) {
+			for (auto collection : collections) {
+				if (!collection->contains(item)) {
+					return;
+				}
+			}
+
+			if (collections.front()->index(item) >= length) {
+				for (auto collection : collections) {
+					collection->swap(collection->index(item), length);
+				}
+
+				length++;
+			}
+		}
+
+		// Pushes the item out of the group, if it belongs to it
+		void release(Collection::Item item) {
+			auto front = collections.front();
+
+			if (front->contains(item) && front->index(item) < length) {
+				length--;
+
+				for (auto collection : collections) {
+					collection->swap(collection->index(item), length);
+				}
+			}
+		}
+
+		// Packs the items all collections already have in common (refreshing reorders the dense set)
+		void pack() {
+			auto smallest = collections.front();
+
+			for (auto collection : collections) {
+				smallest = collection->size() < smallest->size() ? collection : smallest;
+			}
+
+			auto items = smallest->values;
+
+			length = 0U;
+
+			for (auto item : items) {
+				refresh(item);
+			}
+		}
+
+		// Empties the group, which happens whenever one of its collections is cleared
+		void clear() {
+			length = 0U;
+		}
+
+		// Checks whether the group owns exactly the given collections
+		template <typename... Collections>
+		bool owns(const Collections&... owned) const {
+			return sizeof...(Collections) == collections.size() && (... && (owned.owner() == this));
+		}
+
+		unsigned size() const {
+			return length;
+		}
+
+	private:
+		unsigned length = 0U; // Amount of packed items at the front of every owned collection
+		std::vector<Collection*> collections;
 	};
 
 	/**
@@ -103,19 +488,65 @@ namespace ecs
 	* iterate directly the internal packed array (see `raw` and `size` member
 	* functions for that). Use `begin` and `end` instead.
 	*
+	* @note
+	* Components are stored as defined by their `ComponentStorage` policy, and their
+	* changes are notified as defined by their `ComponentNotifications` one.
+	*
 	* @tparam Component Type of component assigned to the entities.
 	*/
 	template <typename Component>
 	class ComponentCollection final : public Collection
 	{
 	public:
+		// Whether the components are laid out in a single array (see `raw`)
+		static constexpr auto CONTIGUOUS = std::is_same<typename ComponentStorage<Component>::type, std::pmr::vector<Component>>::value
+			|| std::is_same<typename ComponentStorage<Component>::type, std::vector<Component>>::value;
+
+		// Whether the components may be adopted in place from a mapped snapshot (see `MappedStorage`)
+		static constexpr auto MAPPED = std::is_same<typename ComponentStorage<Component>::type, MappedStorage<Component>>::value;
+
 		ComponentCollection(const ComponentCollection&) = delete;
 		ComponentCollection(ComponentCollection&&) = default;
-		explicit ComponentCollection(const std::shared_ptr<mqs::MessageManager>& messages) : messages(messages) {}
+		explicit ComponentCollection(const std::shared_ptr<mqs::MessageManager>& messages, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: Collection(resource)
+			, components(makeStorage<typename ComponentStorage<Component>::type>(resource))
+			, messages(messages)
+		{}
 
+		// Removes every component, publishing a single ComponentsRemoved for all of them (unless disabled)
 		void clear() override {
-			components.clear(); // Iterate and send message
-			Collection::clear();
+			auto removed = std::vector<Collection::Item>();
+			auto removedValues = std::vector<Component>();
+
+			if constexpr (NOTIFICATION != Notification::Disabled) {
+				if (messages->listened<ComponentsRemoved<Component>>()) {
+					removed.assign(values.begin(), values.end());
+					removedValues.reserve(size());
+
+					for (auto index = 0U; index < size(); ++index) {
+						removedValues.push_back(components[index]);
+					}
+				}
+			}
+
+			discard();
+
+			if constexpr (NOTIFICATION == Notification::Batched) {
+				removedItems.insert(removedItems.end(), removed.begin(), removed.end());
+				removedComponents.insert(removedComponents.end(), removedValues.begin(), removedValues.end());
+			}
+			else if (!removed.empty()) {
+				messages->publish<ComponentsRemoved<Component>>(removed, removedValues);
+			}
+		}
+
+		void discard() override {
+			components.clear();
+			Collection::discard();
+
+			if (group) {
+				group->clear();
+			}
 		}
 
 		bool reset(Collection::Item item) {
@@ -123,17 +554,23 @@ namespace ecs
 		}
 
 		bool remove(Collection::Item item) override {
-			auto removed = Collection::remove(item);
+			if (!contains(item)) {
+				return false;
+			}
+
+			if (group) {
+				group->release(item); // Moves the item out of the packed front, if there
+			}
+
+			auto index = this->index(item); // Must be fetched before the sparse slot is released
 
-			if (removed) {
-				auto index = indices[item] & ~OCCUPIED;
-				auto component = components[index];
+			notifyRemoval(item, index, [this, item, index]() {
+				Collection::remove(item);
 				components[index] = std::move(components.back()); // Shrink
 				components.pop_back(); // Shrink
-				messages->publish<ComponentRemoved<Component>>(component, item);
-			}
+			});
 
-			return removed;
+			return true;
 		}
 
 		bool add(Collection::Item item, const Component& component) {
@@ -141,21 +578,42 @@ namespace ecs
 
 			if (added) {
 				components.emplace_back(component);
-				messages->publish<ComponentAdded<Component>>(component, item);
+
+				if (group) {
+					group->refresh(item);
+				}
+
+				notifyAddition(item, component);
 			}
 
 			return added;
 		}
 
+		// Adds the component to every given item, publishing a single message for all of them
+		void add(const std::vector<Collection::Item>& items, const Component& component) {
+			append(items, [&component](unsigned) -> const Component& { return component; });
+		}
+
+		// Adds each component to the item at the same position, publishing a single message for all of them
+		void add(const std::vector<Collection::Item>& items, std::vector<Component>& components) {
+			append(items, [&components](unsigned index) -> Component&& { return std::move(components[index]); });
+		}
+
+		void reserve(unsigned count, Collection::Item highest) override {
+			Collection::reserve(count, highest);
+			components.reserve(components.size() + count);
+		}
+
 		bool replace(Collection::Item item, const Component& newComponent) {
 			auto exists = contains(item);
 
 			if (exists) {
-				auto index = indices[item] & ~OCCUPIED;
-				auto oldComponent = components[index];
-				messages->publish<ComponentRemoved<Component>>(oldComponent, item);
+				auto index = this->index(item);
+
+				notifyRemoval(item, index, []() {}); // The old component is only copied if somebody listens
 				components[index] = newComponent;
-				messages->publish<ComponentAdded<Component>>(newComponent, item);
+				touch(item);
+				notifyAddition(item, newComponent);
 			}
 
 			return exists;
@@ -165,13 +623,254 @@ namespace ecs
 			return contains(item) ? replace(item, component) : add(item, component);
 		}
 
-		Component& get(Collection::Item item) {
-			return components[indices[item] & ~OCCUPIED];
+		ComponentReference<Component> get(Collection::Item item) {
+			return components[index(item)];
+		}
+
+		// Component at the given position of the dense set
+		ComponentReference<Component> at(Collection::Index index) {
+			return components[index];
+		}
+
+		// Contiguous components (only available with contiguous storages)
+		Component* raw() {
+			return components.data();
+		}
+
+		// Sorts the entities and their components together, according to the comparison of the components
+		template <typename Compare>
+		void sort(Compare compare, Sorting sorting = Sorting::Full) {
+			if (group) throw "Cannot sort a collection owned by a group";
+
+			if (sorting == Sorting::Incremental) {
+				for (auto index = 1U; index < size(); ++index) {
+					for (auto current = index; current > 0U && compare(components[current], components[current - 1U]); --current) {
+						swap(current - 1U, current);
+					}
+				}
+			}
+			else {
+				auto order = std::vector<Collection::Index>(size());
+
+				std::iota(order.begin(), order.end(), 0U);
+				std::sort(order.begin(), order.end(), [this, &compare](Collection::Index left, Collection::Index right) {
+					return compare(components[left], components[right]);
+				});
+
+				permute(order);
+			}
+		}
+
+		// Underlying storage, in the order of the dense set (e.g. for the field arrays of a `SoAStorage`)
+		typename ComponentStorage<Component>::type& storage() {
+			return components;
+		}
+
+		void serialize(std::ostream& stream) override {
+			Collection::serialize(stream);
+			Binary::write(stream, unsigned(sizeof(Component))); // Detects identifiers bound to other types
+
+			if constexpr (!Serialization::trivial) {
+				for (auto index = 0U; index < size(); ++index) {
+					Serialization::write(stream, at(index));
+				}
+			}
+			else if constexpr (CONTIGUOUS || MAPPED) {
+				Binary::write(stream, components.data(), size());
+			}
+			else {
+				auto buffer = std::vector<Component>();
+				buffer.reserve(size());
+
+				for (auto index = 0U; index < size(); ++index) {
+					buffer.push_back(at(index));
+				}
+
+				Binary::write(stream, buffer.data(), size());
+			}
+		}
+
+		void deserialize(std::istream& stream) override {
+			Collection::deserialize(stream); // Discards the components as well
+
+			if (Binary::read<unsigned>(stream) != sizeof(Component)) throw "Snapshot component type mismatch";
+
+			if constexpr (!Serialization::trivial) {
+				components.reserve(size());
+
+				for (auto index = 0U; index < size(); ++index) {
+					components.emplace_back(Serialization::read(stream));
+				}
+			}
+			else if constexpr (MAPPED) {
+				auto mapping = std::shared_ptr<void>();
+
+				if (auto mapped = MappedBuffer::take<Component>(stream, size(), mapping)) {
+					components.adopt(mapped, size(), std::move(mapping));
+				}
+				else {
+					components.resize(size());
+					Binary::read(stream, components.data(), size());
+				}
+			}
+			else if constexpr (CONTIGUOUS) {
+				components.resize(size());
+				Binary::read(stream, components.data(), size()); // Copied over constructed components
+			}
+			else {
+				auto buffer = std::vector<Component>(size());
+
+				Binary::read(stream, buffer.data(), size());
+				components.reserve(size());
+
+				for (auto& component : buffer) {
+					components.emplace_back(component);
+				}
+			}
+
+			if (group) {
+				group->pack();
+			}
+		}
+
+		std::unique_ptr<Collection> stage() const override {
+			return std::make_unique<ComponentCollection<Component>>(messages, values.get_allocator().resource());
+		}
+
+		void adopt(Collection& staged) override {
+			Collection::adopt(staged);
+
+			using std::swap;
+			swap(components, static_cast<ComponentCollection<Component>&>(staged).components);
+
+			if (group) {
+				group->pack();
+			}
+		}
+
+		void forget() override {
+			addedItems.clear();
+			removedItems.clear();
+			removedComponents.clear();
+		}
+
+		void notify() override {
+			if constexpr (NOTIFICATION == Notification::Batched) {
+				// Handlers may change the collection, hence the batches are moved out first
+				auto added = std::move(addedItems);
+				auto removed = std::move(removedItems);
+				auto removedValues = std::move(removedComponents);
+
+				addedItems.clear();
+				removedItems.clear();
+				removedComponents.clear();
+
+				if (!added.empty()) {
+					messages->publish<ComponentsAdded<Component>>(added);
+				}
+
+				if (!removed.empty()) {
+					messages->publish<ComponentsRemoved<Component>>(removed, removedValues);
+				}
+
+				// Hands the buffers back unless handlers batched more, so that steady frames don't allocate
+				recycle(addedItems, added);
+				recycle(removedItems, removed);
+				recycle(removedComponents, removedValues);
+			}
+		}
+
+	protected:
+		void swap(Collection::Index left, Collection::Index right) override {
+			Collection::swap(left, right);
+			using std::swap;
+			swap(components[left], components[right]); // Proxy references provide their own swap
+		}
+
+	private:
+		template <typename Source>
+		void append(const std::vector<Collection::Item>& items, Source&& source) {
+			auto added = std::vector<Collection::Item>();
+
+			added.reserve(items.size());
+			reserve(items.size(), items.empty() ? 0U : *std::max_element(items.begin(), items.end()));
+
+			for (auto index = 0U; index < items.size(); ++index) {
+				if (Collection::add(items[index])) {
+					components.emplace_back(source(index));
+					added.push_back(items[index]);
+
+					if (group) {
+						group->refresh(items[index]);
+					}
+				}
+			}
+
+			if (!added.empty()) {
+				notifyAdditions(added);
+			}
+		}
+
+		template <typename T>
+		static void recycle(std::vector<T>& batch, std::vector<T>& published) {
+			if (batch.empty()) {
+				published.clear();
+				batch.swap(published);
+			}
+		}
+
+		// Publishes or batches the removal of the component at the given position, made by the given function
+		template <typename Removal>
+		void notifyRemoval(Collection::Item item, Collection::Index index, Removal&& removal) {
+			if constexpr (NOTIFICATION == Notification::Immediate) {
+				if (messages->listened<ComponentRemoved<Component>>()) {
+					Component component = components[index];
+					removal();
+					messages->publish<ComponentRemoved<Component>>(component, item);
+					return;
+				}
+			}
+			else if constexpr (NOTIFICATION == Notification::Batched) {
+				if (messages->listened<ComponentsRemoved<Component>>()) {
+					removedItems.push_back(item);
+					removedComponents.push_back(components[index]);
+				}
+			}
+
+			removal();
+		}
+
+		void notifyAddition(Collection::Item item, const Component& component) {
+			if constexpr (NOTIFICATION == Notification::Immediate) {
+				messages->publish<ComponentAdded<Component>>(component, item);
+			}
+			else if constexpr (NOTIFICATION == Notification::Batched) {
+				if (messages->listened<ComponentsAdded<Component>>()) {
+					addedItems.push_back(item);
+				}
+			}
+		}
+
+		void notifyAdditions(const std::vector<Collection::Item>& items) {
+			if constexpr (NOTIFICATION == Notification::Immediate) {
+				messages->publish<ComponentsAdded<Component>>(items);
+			}
+			else if constexpr (NOTIFICATION == Notification::Batched) {
+				if (messages->listened<ComponentsAdded<Component>>()) {
+					addedItems.insert(addedItems.end(), items.begin(), items.end());
+				}
+			}
 		}
 
 	private:
-		std::vector<Component> components;
+		static constexpr auto NOTIFICATION = ComponentNotifications<Component>::mode;
+		using Serialization = ComponentSerialization<Component>;
+
+		typename ComponentStorage<Component>::type components;
 		std::shared_ptr<mqs::MessageManager> messages;
+		std::vector<Collection::Item> addedItems; // Batched notifications
+		std::vector<Collection::Item> removedItems;
+		std::vector<Component> removedComponents;
 	};
 }
 
@@ -1,8 +1,8 @@
 #ifndef ENTITIES_COMPONENT_COLLECTION_INTERSECTION_IMPL
 #define ENTITIES_COMPONENT_COLLECTION_INTERSECTION_IMPL
 
+#include <array>
 #include <tuple>
-#include <vector>
 #include <cstdint>
 #include <algorithm>
 
@@ -10,22 +10,34 @@
 
 namespace ecs
 {
+	/**
+	* @brief Intersection of component collections.
+	*
+	* Iterates over the smallest collection and probes the remaining ones, which are
+	* kept in a fixed-size array sized at compile time. Neither the intersection nor
+	* its iterators allocate. When the collections track the signatures of the entities
+	* (see `Collection::track`), probing is a single mask test, otherwise it goes through
+	* the non-virtual `contains` of every other collection. Excluded components (see
+	* `exclude`) are folded into that mask test, hence they need tracked collections.
+	*/
 	template <typename... Components>
 	class ComponentCollectionIntersection final
 	{
 	public:
+		using Others = std::array<const ecs::Collection*, sizeof...(Components) - 1U>;
+
 		class Iterator final //: public std::iterator<std::input_iterator_tag, std::uint32_t>
 		{
 		public:
 			// C++17 iterator traits
 			using difference_type = unsigned;
-			using value_type = unsigned;
-			using pointer = const unsigned*;
-			using reference = const unsigned&;
+			using value_type = ecs::Collection::Item;
+			using pointer = const ecs::Collection::Item*;
+			using reference = const ecs::Collection::Item&;
 			using iterator_category = std::input_iterator_tag;
 
-			Iterator(std::vector<ecs::Collection*> others, ecs::Collection::Iterator begin, ecs::Collection::Iterator end)
-				: collections(others)
+			Iterator(const ComponentCollectionIntersection& intersection, ecs::Collection::Iterator begin, ecs::Collection::Iterator end)
+				: intersection(&intersection)
 				, begin(begin)
 				, end(end)
 			{
@@ -34,7 +46,8 @@ namespace ecs
 			}
 
 			Iterator& operator++() { // ++i
-				return (++begin != end && !intersects()) ? ++(*this) : (*this);
+				while (++begin != end && !intersects());
+				return *this;
 			}
 
 			Iterator operator++(int) { // i++
@@ -43,7 +56,7 @@ namespace ecs
 				return it;
 			}
 
-			std::uint32_t operator*() const {
+			ecs::Collection::Item operator*() const {
 				return *begin;
 			}
 
@@ -57,24 +70,18 @@ namespace ecs
 
 		protected:
 			bool intersects() const {
-				auto index = collections.size();
-
-				// For all the other sets, check whether they have the smallest set's begin iterator value
-				for (auto entity = *begin; index && collections[index - 1U]->contains(entity); --index);
-
-				// Will only return true if index ever reaches 0 (both comparables contain it)
-				return index == 0U;
+				return intersection->contains(*begin);
 			}
 
 		private:
+			const ComponentCollectionIntersection* intersection;
 			ecs::Collection::Iterator begin;
 			ecs::Collection::Iterator end;
-			std::vector<ecs::Collection*> collections;
 		};
 
 		ComponentCollectionIntersection(ecs::ComponentCollection<Components>&... collections)
-			: others(sizeof...(Components) - 1U)
-			, smallest(nullptr)
+			: smallest(nullptr)
+			, others()
 			, all(collections...)
 		{
 			auto index = 0U;
@@ -93,14 +100,63 @@ namespace ecs
 			// Execute lambdas using braced-init-lists technique
 			auto probing = { 0U, (size = probe(size, collections), 0U)... };
 			auto filtering = { 0U, (index = filter(index, collections), 0U)... };
+
+			// Probe the signatures instead, if all collections keep the same ones up to date
+			signatures = smallest->tracked();
+
+			for (auto collection : others) {
+				signatures = collection->tracked() == signatures ? signatures : nullptr;
+				required |= collection->mask();
+			}
 		}
 
+		ComponentCollectionIntersection(const ComponentCollectionIntersection&) = delete; // Iterators point to the intersection
+
 		Iterator begin() {
-			return Iterator(others, smallest->begin(), smallest->end());
+			return Iterator(*this, smallest->begin(), smallest->end());
 		}
 
 		Iterator end() {
-			return Iterator(others, smallest->end(), smallest->end());
+			return Iterator(*this, smallest->end(), smallest->end());
+		}
+
+		// Collection driving the iteration, which is the smallest one
+		const ecs::Collection& driver() const {
+			return *smallest;
+		}
+
+		// Leaves out the items of the entities having any of the components of the mask
+		void exclude(const Signature& mask) {
+			if (mask.none()) return;
+			if (!signatures) throw "Exclusions need collections tracking the same signatures";
+
+			excluded |= mask;
+		}
+
+		// Checks whether any component is excluded
+		bool excluding() const {
+			return excluded.any();
+		}
+
+		// Checks whether the item belongs to an entity having an excluded component
+		bool excludes(ecs::Collection::Item item) const {
+			return excluded.any() && ((*signatures)[item & Entity::ID_MASK] & excluded).any();
+		}
+
+		// Checks whether the collections other than the driving one contain the item, and no excluded one does
+		bool contains(ecs::Collection::Item item) const {
+			if (signatures) {
+				auto& signature = (*signatures)[item & Entity::ID_MASK];
+				return (signature & required) == required && (signature & excluded).none();
+			}
+
+			for (auto collection : others) {
+				if (!collection->contains(item)) {
+					return false;
+				}
+			}
+
+			return true;
 		}
 
 		template <typename Component>
@@ -108,9 +164,18 @@ namespace ecs
 			return std::get<ComponentCollection<Component>&>(all);
 		}
 
+		// Group owning exactly the intersected collections, if any
+		const ComponentGroup* group() const {
+			auto owner = std::get<0>(all).owner();
+			return owner && std::apply([owner](auto&... collections) { return owner->owns(collections...); }, all) ? owner : nullptr;
+		}
+
 	private:
 		ecs::Collection* smallest;
-		std::vector<ecs::Collection*> others;
+		Others others;
+		const std::pmr::vector<Signature>* signatures = nullptr; // Shared by all collections, if tracked
+		Signature required; // Bits of the collections other than the driving one
+		Signature excluded; // Bits of the excluded components, tested against the same signature
 		std::tuple<ComponentCollection<Components>&...> all;
 	};
 }
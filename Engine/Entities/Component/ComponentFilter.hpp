@@ -0,0 +1,116 @@
+#ifndef ENTITIES_COMPONENT_FILTER_IMPL
+#define ENTITIES_COMPONENT_FILTER_IMPL
+
+#include <cstddef>
+
+#include "ComponentCollection.hpp"
+
+namespace ecs
+{
+	/**
+	* @brief Query filter: only entities whose component was added or changed (see
+	* `Collection::touch`) since the querying system last ran.
+	*
+	* @code
+	* entities->each<Changed<Transform>, Body>([](auto& entity, Transform& transform, Body& body) {});
+	* @endcode
+	*/
+	template <typename Component>
+	struct Changed final {};
+
+	/**
+	* @brief Query filter: only entities whose component was added since the querying
+	* system last ran.
+	*/
+	template <typename Component>
+	struct Added final {};
+
+	/**
+	* @brief Components an iteration leaves out, passed ahead of its callback. Entities having
+	* any of them are skipped with a single test against their signature.
+	*
+	* @code
+	* entities->each<Motion, Transform>(ecs::exclude<Joystick>, [](auto& entity, Motion& motion, Transform& transform) {});
+	* @endcode
+	*/
+	template <typename... Components>
+	struct Exclude final {};
+
+	template <typename... Components>
+	constexpr Exclude<Components...> exclude{};
+
+	// Component type of a query term, and whether the term accepts a given item (or position, within a collection or an archetype column)
+	template <typename Query>
+	struct ComponentFilter
+	{
+		using type = Query;
+
+		static constexpr bool filtering = false;
+
+		static bool accepts(const Collection&, Collection::Item, unsigned) {
+			return true;
+		}
+
+		template <typename Storage>
+		static bool admits(const Storage&, Collection::Index, unsigned) {
+			return true;
+		}
+	};
+
+	template <typename Component>
+	struct ComponentFilter<Changed<Component>>
+	{
+		using type = Component;
+
+		static constexpr bool filtering = true;
+
+		static bool accepts(const Collection& collection, Collection::Item item, unsigned since) {
+			return collection.changed(item) > since;
+		}
+
+		template <typename Storage>
+		static bool admits(const Storage& storage, Collection::Index index, unsigned since) {
+			return storage.changedAt(index) > since;
+		}
+	};
+
+	template <typename Component>
+	struct ComponentFilter<Added<Component>>
+	{
+		using type = Component;
+
+		static constexpr bool filtering = true;
+
+		static bool accepts(const Collection& collection, Collection::Item item, unsigned since) {
+			return collection.added(item) > since;
+		}
+
+		template <typename Storage>
+		static bool admits(const Storage& storage, Collection::Index index, unsigned since) {
+			return storage.addedAt(index) > since;
+		}
+	};
+
+	template <typename Query>
+	using FilteredComponent = typename ComponentFilter<Query>::type;
+
+	template <typename... Queries>
+	constexpr bool filtering() {
+		return (... || ComponentFilter<Queries>::filtering);
+	}
+
+	// Position of the first filtering term among the queries
+	template <typename... Queries>
+	constexpr std::size_t firstFilter() {
+		constexpr bool filters[] = { ComponentFilter<Queries>::filtering... };
+		auto index = std::size_t(0U);
+
+		while (!filters[index]) {
+			index++;
+		}
+
+		return index;
+	}
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef ENTITIES_COMPONENT_NOTIFICATIONS_IMPL
+#define ENTITIES_COMPONENT_NOTIFICATIONS_IMPL
+
+namespace ecs
+{
+	enum class Notification
+	{
+		Immediate, // ComponentAdded and ComponentRemoved are published on every change
+		Batched, // ComponentsAdded and ComponentsRemoved are published once per frame (see `EntityManager::flush`)
+		Disabled // Nothing is published
+	};
+
+	/**
+	* @brief Lifecycle notification policy of a component type.
+	*
+	* Whatever the mode, nothing is built or copied for messages nobody listens to.
+	* Replacing a component counts as a removal followed by an addition. Batches list the
+	* entities in change order, thus an entity may appear in both the additions and the
+	* removals of a frame.
+	*
+	* @code
+	* template <> struct ecs::ComponentNotifications<Transform> { static constexpr auto mode = ecs::Notification::Disabled; };
+	* @endcode
+	*/
+	template <typename Component>
+	struct ComponentNotifications
+	{
+		static constexpr auto mode = Notification::Immediate;
+	};
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef ENTITIES_COMPONENT_SERIALIZATION_IMPL
+#define ENTITIES_COMPONENT_SERIALIZATION_IMPL
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <streambuf>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace ecs
+{
+	// Raw binary encoding of trivially copyable values, in the native byte order
+	struct Binary final
+	{
+		template <typename T>
+		static void write(std::ostream& stream, const T* values, unsigned count) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values are written raw");
+			stream.write(reinterpret_cast<const char*>(values), std::streamsize(count) * sizeof(T));
+		}
+
+		template <typename T>
+		static void write(std::ostream& stream, const T& value) {
+			write(stream, &value, 1U);
+		}
+
+		// Writes the size of the array, then its values
+		template <typename T, typename Allocator>
+		static void write(std::ostream& stream, const std::vector<T, Allocator>& values) {
+			write(stream, unsigned(values.size()));
+			write(stream, values.data(), values.size());
+		}
+
+		template <typename T>
+		static void read(std::istream& stream, T* values, unsigned count) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values are read raw");
+			stream.read(reinterpret_cast<char*>(values), std::streamsize(count) * sizeof(T));
+
+			if (!stream) throw "Truncated snapshot";
+		}
+
+		template <typename T>
+		static T read(std::istream& stream) {
+			auto value = T();
+			read(stream, &value, 1U);
+			return value;
+		}
+
+		template <typename T, typename Allocator>
+		static void read(std::istream& stream, std::vector<T, Allocator>& values) {
+			values.resize(read<unsigned>(stream));
+			read(stream, values.data(), values.size());
+		}
+	};
+
+	/**
+	* @brief Stream buffer over memory which may outlive the stream, such as a mapped snapshot file.
+	*
+	* Storages able to adopt memory (see `MappedStorage`) take their components from the buffer
+	* in place rather than copying them, sharing the ownership of the memory.
+	*/
+	class MappedBuffer : public std::streambuf
+	{
+	public:
+		// Next values of the stream in place and skips them, if it reads such memory and they are aligned
+		template <typename T>
+		static T* take(std::istream& stream, unsigned count, std::shared_ptr<void>& owner) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values are taken in place");
+
+			auto buffer = dynamic_cast<MappedBuffer*>(stream.rdbuf());
+			auto bytes = std::size_t(count) * sizeof(T);
+
+			if (!buffer || !count || std::size_t(buffer->egptr() - buffer->gptr()) < bytes) return nullptr;
+			if (reinterpret_cast<std::uintptr_t>(buffer->gptr()) % alignof(T)) return nullptr;
+
+			auto values = reinterpret_cast<T*>(buffer->gptr()); // Mapped pages implicitly hold the values
+			buffer->setg(buffer->eback(), buffer->gptr() + bytes, buffer->egptr());
+			owner = buffer->memory;
+			return values;
+		}
+
+	protected:
+		void expose(char* begin, std::size_t length, const std::shared_ptr<void>& memory) {
+			setg(begin, begin, begin + length);
+			this->memory = memory;
+		}
+
+	private:
+		std::shared_ptr<void> memory;
+	};
+
+	/**
+	* @brief Snapshot encoding policy of a component type.
+	*
+	* Trivially copyable components are written raw, with a single copy per collection
+	* when stored contiguously, and read back over default constructed ones. Specialize it
+	* to write any other component (including trivially copyable components which can't
+	* be default constructed) one by one:
+	*
+	* @code
+	* template <> struct ecs::ComponentSerialization<Name> {
+	* 	static constexpr bool trivial = false;
+	* 	static void write(std::ostream& stream, const Name& name) { ... }
+	* 	static Name read(std::istream& stream) { ... }
+	* };
+	* @endcode
+	*/
+	template <typename Component>
+	struct ComponentSerialization
+	{
+		static constexpr bool trivial = std::is_trivially_copyable<Component>::value && std::is_default_constructible<Component>::value;
+
+		static void write(std::ostream&, const Component&) {
+			throw "Component not serializable";
+		}
+
+		static Component read(std::istream&) {
+			throw "Component not serializable";
+		}
+	};
+}
+
+#endif
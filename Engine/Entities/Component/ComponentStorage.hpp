@@ -0,0 +1,470 @@
+#ifndef ENTITIES_COMPONENT_STORAGE_IMPL
+#define ENTITIES_COMPONENT_STORAGE_IMPL
+
+#include <new>
+#include <cstring>
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <memory_resource>
+#include <type_traits>
+
+namespace ecs
+{
+	/**
+	* @brief Component storage made of fixed-size chunks.
+	*
+	* Growing allocates a new chunk instead of reallocating and moving every component,
+	* hence there are no latency spikes when crossing a capacity boundary and references
+	* to components stay valid as other components are added. Removals still move the last
+	* component into the removed slot. Positions are laid out linearly across the chunks.
+	* Chunks are drawn from the memory resource given at construction.
+	*
+	* @tparam Component Type of the stored components.
+	* @tparam Size Amount of components per chunk (power of two).
+	*/
+	template <typename Component, unsigned Size = 1024U>
+	class ChunkedStorage final
+	{
+		static_assert(Size && (Size & (Size - 1U)) == 0U, "Chunk size must be a power of two");
+
+	public:
+		static constexpr unsigned CHUNK_SIZE = Size;
+
+		ChunkedStorage() : ChunkedStorage(std::pmr::get_default_resource()) {}
+		explicit ChunkedStorage(std::pmr::memory_resource* resource) : chunks(resource) {}
+		ChunkedStorage(const ChunkedStorage&) = delete;
+		ChunkedStorage(ChunkedStorage&& other) : count(other.count), chunks(std::move(other.chunks)) {
+			other.count = 0U;
+			other.chunks.clear();
+		}
+
+		~ChunkedStorage() {
+			clear();
+
+			for (auto chunk : chunks) {
+				chunks.get_allocator().resource()->deallocate(chunk, sizeof(Chunk), alignof(Chunk));
+			}
+		}
+
+		unsigned size() const {
+			return count;
+		}
+
+		bool empty() const {
+			return count == 0U;
+		}
+
+		void reserve(unsigned capacity) {
+			while (chunks.size() * Size < capacity) {
+				chunks.push_back(new (chunks.get_allocator().resource()->allocate(sizeof(Chunk), alignof(Chunk))) Chunk);
+			}
+		}
+
+		void clear() {
+			while (count) {
+				pop_back();
+			}
+		}
+
+		template <typename... Args>
+		Component& emplace_back(Args&&... args) {
+			reserve(count + 1U);
+			auto component = new (slot(count)) Component(std::forward<Args>(args)...);
+			count++;
+			return *component;
+		}
+
+		void pop_back() {
+			count--;
+			slot(count)->~Component();
+		}
+
+		Component& back() {
+			return *slot(count - 1U);
+		}
+
+		Component& operator[](unsigned index) {
+			return *slot(index);
+		}
+
+		const Component& operator[](unsigned index) const {
+			return *slot(index);
+		}
+
+		friend void swap(ChunkedStorage& left, ChunkedStorage& right) {
+			std::swap(left.count, right.count);
+			left.chunks.swap(right.chunks);
+		}
+
+	private:
+		struct Chunk final
+		{
+			typename std::aligned_storage<sizeof(Component), alignof(Component)>::type slots[Size];
+		};
+
+		Component* slot(unsigned index) const {
+			return reinterpret_cast<Component*>(&chunks[index / Size]->slots[index & (Size - 1U)]);
+		}
+
+	private:
+		unsigned count = 0U;
+		std::pmr::vector<Chunk*> chunks;
+	};
+
+	/**
+	* @brief Contiguous component storage able to adopt the components of a mapped snapshot.
+	*
+	* Restoring a snapshot mapped in memory (see `EntityManager::load`) makes the storage point
+	* into the mapping instead of copying the components out of it: pages are only read as the
+	* components are accessed, and privately copied by the system as they are written, the file
+	* being left untouched. The storage moves its components into memory of its own, drawn from
+	* the resource given at construction, as soon as it grows beyond the mapped ones. Otherwise
+	* it behaves as a `std::vector`, e.g. when filled by additions.
+	*
+	* @tparam Component Type of the stored components, which must be trivially copyable.
+	*/
+	template <typename Component>
+	class MappedStorage final
+	{
+		static_assert(std::is_trivially_copyable<Component>::value, "Mapped components must be trivially copyable");
+
+	public:
+		MappedStorage() : MappedStorage(std::pmr::get_default_resource()) {}
+		explicit MappedStorage(std::pmr::memory_resource* resource) : resource(resource) {}
+		MappedStorage(const MappedStorage&) = delete;
+		MappedStorage(MappedStorage&& other) : resource(other.resource) {
+			swap(*this, other);
+		}
+
+		~MappedStorage() {
+			release();
+		}
+
+		unsigned size() const {
+			return count;
+		}
+
+		bool empty() const {
+			return count == 0U;
+		}
+
+		void reserve(unsigned size) {
+			if (size > capacity) {
+				auto items = static_cast<Component*>(resource->allocate(sizeof(Component) * size, alignof(Component)));
+
+				if (count) {
+					std::memcpy(items, this->items, sizeof(Component) * count);
+				}
+
+				auto kept = count;
+				release();
+				this->items = items;
+				count = kept;
+				capacity = size;
+			}
+		}
+
+		void resize(unsigned size) {
+			reserve(size);
+
+			while (count < size) {
+				emplace_back();
+			}
+
+			count = size;
+		}
+
+		void clear() {
+			count = 0U;
+		}
+
+		template <typename... Args>
+		Component& emplace_back(Args&&... args) {
+			if (count == capacity) {
+				reserve(capacity ? capacity * 2U : 16U);
+			}
+
+			return *new (items + count++) Component(std::forward<Args>(args)...);
+		}
+
+		void pop_back() {
+			count--;
+		}
+
+		Component& back() {
+			return items[count - 1U];
+		}
+
+		Component& operator[](unsigned index) {
+			return items[index];
+		}
+
+		const Component& operator[](unsigned index) const {
+			return items[index];
+		}
+
+		Component* data() {
+			return items;
+		}
+
+		const Component* data() const {
+			return items;
+		}
+
+		// Uses mapped components in place, sharing the ownership of the mapping
+		void adopt(Component* mapped, unsigned size, std::shared_ptr<void> mapping) {
+			release();
+			items = mapped;
+			count = size;
+			capacity = size;
+			this->mapping = std::move(mapping);
+		}
+
+		// Whether the components still live in a mapping
+		bool mapped() const {
+			return mapping != nullptr;
+		}
+
+		friend void swap(MappedStorage& left, MappedStorage& right) {
+			std::swap(left.items, right.items);
+			std::swap(left.count, right.count);
+			std::swap(left.capacity, right.capacity);
+			std::swap(left.mapping, right.mapping);
+			std::swap(left.resource, right.resource);
+		}
+
+	private:
+		void release() {
+			if (mapping) {
+				mapping.reset();
+			}
+			else if (items) {
+				resource->deallocate(items, sizeof(Component) * capacity, alignof(Component));
+			}
+
+			items = nullptr;
+			count = 0U;
+			capacity = 0U;
+		}
+
+	private:
+		Component* items = nullptr;
+		unsigned count = 0U;
+		unsigned capacity = 0U;
+		std::shared_ptr<void> mapping; // Keeps the mapped snapshot alive, if the components live there
+		std::pmr::memory_resource* resource;
+	};
+
+	template <typename>
+	struct MemberTraits;
+
+	template <typename Class, typename Field>
+	struct MemberTraits<Field Class::*>
+	{
+		using component = Class;
+		using type = Field;
+	};
+
+	template <auto Field, auto... Fields>
+	class SoAStorage;
+
+	/**
+	* @brief Proxy to a component of a structure of arrays storage.
+	*
+	* Fields are accessed through their member pointer (`transform[&Transform::x] += 1.f`).
+	* The proxy converts to a copy of the component and assigning a component (or another
+	* proxy) scatters its fields. Proxies are handed out by value, so iteration callbacks
+	* must take such components as `auto` or `auto&&` rather than `Component&`.
+	*/
+	template <auto Field, auto... Fields>
+	class SoAReference final
+	{
+	public:
+		using Component = typename MemberTraits<decltype(Field)>::component;
+		using Storage = SoAStorage<Field, Fields...>;
+
+		SoAReference(Storage& storage, unsigned index) : storage(&storage), index(index) {}
+		SoAReference(const SoAReference&) = default;
+
+		SoAReference& operator=(const SoAReference& other) {
+			return *this = Component(other);
+		}
+
+		SoAReference& operator=(const Component& component) {
+			scatter(component, std::index_sequence_for<decltype(Field), decltype(Fields)...>());
+			return *this;
+		}
+
+		operator Component() const {
+			return gather(std::index_sequence_for<decltype(Field), decltype(Fields)...>());
+		}
+
+		template <typename Type>
+		Type& operator[](Type Component::* member) const {
+			return *find(member, std::index_sequence_for<decltype(Field), decltype(Fields)...>());
+		}
+
+		friend void swap(SoAReference left, SoAReference right) {
+			Component component = left;
+			left = right;
+			right = component;
+		}
+
+	private:
+		template <std::size_t... Indices>
+		void scatter(const Component& component, std::index_sequence<Indices...>) const {
+			auto assigning = { 0, (std::get<Indices>(storage->arrays)[index] = component.*std::get<Indices>(Storage::fields), 0)... };
+		}
+
+		template <std::size_t... Indices>
+		Component gather(std::index_sequence<Indices...>) const {
+			Component component;
+			auto assigning = { 0, (component.*std::get<Indices>(Storage::fields) = std::get<Indices>(storage->arrays)[index], 0)... };
+			return component;
+		}
+
+		template <typename Type, std::size_t... Indices>
+		Type* find(Type Component::* member, std::index_sequence<Indices...>) const {
+			Type* found = nullptr;
+			auto matching = { 0, (found = found ? found : match<Indices>(member), 0)... };
+			return found;
+		}
+
+		template <std::size_t Index, typename Type>
+		Type* match(Type Component::* member) const {
+			if constexpr (std::is_same<decltype(std::get<Index>(Storage::fields)), Type Component::* const&>::value) {
+				return member == std::get<Index>(Storage::fields) ? &std::get<Index>(storage->arrays)[index] : nullptr;
+			}
+			else {
+				return nullptr;
+			}
+		}
+
+	private:
+		Storage* storage;
+		unsigned index;
+	};
+
+	/**
+	* @brief Structure of arrays component storage, with one contiguous array per field.
+	*
+	* Loops touching a few fields only load those, and per field arrays can be vectorized
+	* (see `data`), each array drawing from the memory resource given at construction.
+	* Elements are exposed as `SoAReference` proxies. Every field of the component must
+	* be listed, and the component must be default constructible:
+	*
+	* @code
+	* template <> struct ecs::ComponentStorage<Particle> { using type = ecs::SoAStorage<&Particle::x, &Particle::y>; };
+	* @endcode
+	*/
+	template <auto Field, auto... Fields>
+	class SoAStorage final
+	{
+		friend class SoAReference<Field, Fields...>;
+
+	public:
+		using Component = typename MemberTraits<decltype(Field)>::component;
+		using Reference = SoAReference<Field, Fields...>;
+
+		static_assert(std::is_default_constructible<Component>::value, "Structure of arrays components must be default constructible");
+
+		SoAStorage() : SoAStorage(std::pmr::get_default_resource()) {}
+		explicit SoAStorage(std::pmr::memory_resource* resource) : arrays(resource, same<Fields>(resource)...) {}
+		SoAStorage(const SoAStorage&) = delete;
+		SoAStorage(SoAStorage&&) = default;
+
+		unsigned size() const {
+			return unsigned(std::get<0>(arrays).size());
+		}
+
+		bool empty() const {
+			return std::get<0>(arrays).empty();
+		}
+
+		void reserve(unsigned capacity) {
+			std::apply([capacity](auto&... array) { auto reserving = { 0, (array.reserve(capacity), 0)... }; }, arrays);
+		}
+
+		void clear() {
+			std::apply([](auto&... array) { auto clearing = { 0, (array.clear(), 0)... }; }, arrays);
+		}
+
+		template <typename... Args>
+		Reference emplace_back(Args&&... args) {
+			std::apply([](auto&... array) { auto growing = { 0, (array.emplace_back(), 0)... }; }, arrays);
+			return back() = Component(std::forward<Args>(args)...);
+		}
+
+		void pop_back() {
+			std::apply([](auto&... array) { auto shrinking = { 0, (array.pop_back(), 0)... }; }, arrays);
+		}
+
+		Reference back() {
+			return Reference(*this, size() - 1U);
+		}
+
+		Reference operator[](unsigned index) {
+			return Reference(*this, index);
+		}
+
+		friend void swap(SoAStorage& left, SoAStorage& right) {
+			left.arrays.swap(right.arrays);
+		}
+
+		// Contiguous values of a single field
+		template <typename Type>
+		Type* data(Type Component::* member) {
+			return empty() ? nullptr : &Reference(*this, 0U)[member];
+		}
+
+	private:
+		static constexpr auto fields = std::make_tuple(Field, Fields...);
+
+		// Repeats the memory resource once per field
+		template <auto>
+		static std::pmr::memory_resource* same(std::pmr::memory_resource* resource) {
+			return resource;
+		}
+
+		std::tuple<std::pmr::vector<typename MemberTraits<decltype(Field)>::type>, std::pmr::vector<typename MemberTraits<decltype(Fields)>::type>...> arrays;
+	};
+
+	/**
+	* @brief Storage policy of a component type.
+	*
+	* Components are stored contiguously by default. Specialize it to opt into another
+	* storage, which must provide the same subset of the `std::vector` interface as
+	* `ChunkedStorage` does (`SoAStorage` hands out proxies instead of references). Storages
+	* constructible from a `std::pmr::memory_resource*` draw from the resource of their world:
+	*
+	* @code
+	* template <> struct ecs::ComponentStorage<Body> { using type = ecs::ChunkedStorage<Body>; };
+	* template <> struct ecs::ComponentStorage<Motion> { using type = ecs::MappedStorage<Motion>; };
+	* template <> struct ecs::ComponentStorage<Transform> { using type = ecs::SoAStorage<&Transform::x, &Transform::y, &Transform::z>; };
+	* @endcode
+	*/
+	template <typename Component>
+	struct ComponentStorage
+	{
+		using type = std::pmr::vector<Component>;
+	};
+
+	// Builds a storage drawing from the given memory resource, if the storage accepts one
+	template <typename Storage>
+	Storage makeStorage(std::pmr::memory_resource* resource) {
+		if constexpr (std::is_constructible<Storage, std::pmr::memory_resource*>::value) {
+			return Storage(resource);
+		}
+		else {
+			return Storage();
+		}
+	}
+
+	// Type handed out when accessing a stored component (`Component&` or a proxy)
+	template <typename Component>
+	using ComponentReference = decltype(std::declval<typename ComponentStorage<Component>::type&>()[0U]);
+}
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef ENTITIES_COMPONENT_VIEW_IMPL
 #define ENTITIES_COMPONENT_VIEW_IMPL
 
-#include <functional>
+#include <array>
+#include <tuple>
+#include <utility>
 
+#include "Span.hpp"
 #include "../Entity/Entity.h"
+#include "../../Threads/ThreadPool.hpp"
 #include "../Component/ComponentCollectionIntersection.hpp"
 
 namespace ecs
@@ -20,14 +24,166 @@ namespace ecs
 			, intersection(components...)
 		{}
 
+		// Leaves out the entities having any of the components of the mask (see `EntityManager::signature`)
+		ComponentView& exclude(const Signature& mask) {
+			intersection.exclude(mask);
+			return *this;
+		}
+
+		/**
+		* @brief Invokes the callback for every entity having all the components.
+		*
+		* When the collections are owned by a group, the matching entities are packed at the
+		* front of every collection, hence they are walked linearly with no membership tests.
+		*/
+		template <typename Lambda>
+		void each(Lambda&& callback) {
+			if (auto group = intersection.group()) {
+				auto entities = intersection.template get<std::tuple_element_t<0, std::tuple<Components...>>>().data();
+				auto components = std::tie(intersection.template get<Components>()...);
+
+				for (auto index = 0U; index < group->size(); ++index) {
+					if (intersection.excludes(entities[index])) continue;
+
+					auto entity = Entity(entities[index], manager);
+					callback(entity, std::get<ComponentCollection<Components>&>(components).at(index)...);
+				}
+			}
+			else {
+				for (auto entityId : intersection) {
+					auto entity = Entity(entityId, manager);
+					callback(entity, intersection.template get<Components>().get(entityId)...);
+				}
+			}
+		}
+
 		/**
-		* @brief 
+		* @brief Invokes the callback for every entity having all the components, in parallel.
+		*
+		* The dense array driving the iteration (the group, if any, otherwise the smallest
+		* collection) is split into chunks of the given size (zero picks one) which are
+		* spread across the pool. Each entity is visited by a single thread, hence the callback
+		* may freely write the components it is handed. It must not touch components of other
+		* entities, change the structure (create, destroy, assign, remove) or publish messages.
 		*/
-		void each(std::function<void(Entity&, Components&...)>& callback) {
-			for (auto entityId : intersection) {
-				auto entity = Entity(entityId, manager);
-				callback(entity, intersection.get<Components>().get(entityId)...);
+		template <typename Lambda>
+		void parallelEach(ths::ThreadPool& pool, unsigned chunk, Lambda&& callback) {
+			if (auto group = intersection.group()) {
+				auto entities = intersection.template get<std::tuple_element_t<0, std::tuple<Components...>>>().data();
+				auto components = std::tie(intersection.template get<Components>()...);
+
+				pool.chunked(group->size(), chunk, [&](unsigned begin, unsigned end) {
+					for (auto index = begin; index < end; ++index) {
+						if (intersection.excludes(entities[index])) continue;
+
+						auto entity = Entity(entities[index], manager);
+						callback(entity, std::get<ComponentCollection<Components>&>(components).at(index)...);
+					}
+				});
 			}
+			else {
+				auto entities = intersection.driver().data();
+
+				pool.chunked(intersection.driver().size(), chunk, [&](unsigned begin, unsigned end) {
+					for (auto index = begin; index < end; ++index) {
+						if (intersection.contains(entities[index])) {
+							auto entity = Entity(entities[index], manager);
+							callback(entity, intersection.template get<Components>().get(entities[index])...);
+						}
+					}
+				});
+			}
+		}
+
+		/**
+		* @brief Invokes the callback with runs of entities having all the components, handed as
+		* spans over the dense arrays (entity identifiers first, then one span per component).
+		*
+		* Grouped collections yield a single run, as do collections ordered alike (see
+		* `EntityManager::respect`). Otherwise a run ends wherever the entities stop being laid
+		* out consecutively in every collection. Components must be stored contiguously.
+		*/
+		template <typename Lambda>
+		void eachChunk(Lambda&& callback) {
+			runs(0U, range(), callback, std::index_sequence_for<Components...>());
+		}
+
+		/**
+		* @brief Invokes the callback with runs of entities having all the components, in parallel.
+		*
+		* The positions are split into chunks of the given size (zero picks one) which are spread
+		* across the pool, runs never spanning two chunks. Same contract as `parallelEach`.
+		*/
+		template <typename Lambda>
+		void parallelEachChunk(ths::ThreadPool& pool, unsigned chunk, Lambda&& callback) {
+			pool.chunked(range(), chunk, [&](unsigned begin, unsigned end) {
+				runs(begin, end, callback, std::index_sequence_for<Components...>());
+			});
+		}
+
+	private:
+		// Amount of positions to walk: the group, if any, otherwise the dense set of the driving collection
+		unsigned range() const {
+			auto group = intersection.group();
+			return group ? group->size() : intersection.driver().size();
+		}
+
+		// Hands the runs found between the given positions to the callback
+		template <typename Lambda, std::size_t... Indices>
+		void runs(unsigned begin, unsigned end, Lambda& callback, std::index_sequence<Indices...>) {
+			static_assert((... && ComponentCollection<Components>::CONTIGUOUS), "Only contiguous storages can be spanned");
+
+			auto collections = std::tie(intersection.template get<Components>()...);
+			auto grouped = intersection.group() != nullptr;
+
+			// Owned collections line up position by position, so the whole range is a single run
+			if (grouped && !intersection.excluding()) {
+				if (begin < end) {
+					callback(Span<const Collection::Item>(std::get<0>(collections).data() + begin, end - begin), Span<Components>(std::get<Indices>(collections).raw() + begin, end - begin)...);
+				}
+
+				return;
+			}
+
+			auto entities = grouped ? std::get<0>(collections).data() : intersection.driver().data();
+			auto start = std::array<Collection::Index, sizeof...(Components)>();
+			auto positions = start;
+			auto length = 0U;
+
+			auto flush = [&]() {
+				if (length) {
+					callback(Span<const Collection::Item>(std::get<0>(collections).data() + start[0], length), Span<Components>(std::get<Indices>(collections).raw() + start[Indices], length)...);
+				}
+
+				length = 0U;
+			};
+
+			for (auto index = begin; index < end; ++index) {
+				auto item = entities[index];
+
+				if (grouped ? intersection.excludes(item) : !intersection.contains(item)) {
+					flush();
+					continue;
+				}
+
+				if (grouped) {
+					positions.fill(index); // Same position in every owned collection
+				}
+				else {
+					positions = { std::get<Indices>(collections).index(item)... };
+				}
+
+				if (length && (... && (positions[Indices] == start[Indices] + length))) {
+					length++;
+				}
+				else {
+					flush();
+					start = positions;
+					length = 1U;
+				}
+			}
+
+			flush();
 		}
 
 	private:
@@ -47,19 +203,102 @@ namespace ecs
 			, components(components)
 		{}
 
+		// Leaves out the entities having any of the components of the mask, tested against their signatures
+		ComponentView& exclude(const Signature& mask) {
+			if (mask.none()) return *this;
+			if (!components.tracked()) throw "Exclusions need collections tracking the signatures";
+
+			signatures = components.tracked();
+			excluded |= mask;
+			return *this;
+		}
+
 		/**
-		* @brief
+		* @brief Invokes the callback for every entity having the component.
 		*/
-		void each(std::function<void(Entity&, Component&)>& callback) {
-			for (auto entityId : components) {
-				auto entity = Entity(entityId, manager);
-				callback(entity, components.get(entityId));
+		template <typename Lambda>
+		void each(Lambda&& callback) {
+			if (signatures) {
+				auto entities = components.data();
+
+				for (auto index = 0U; index < components.size(); ++index) {
+					if (((*signatures)[entities[index] & Entity::ID_MASK] & excluded).none()) {
+						auto entity = Entity(entities[index], manager);
+						callback(entity, components.at(index));
+					}
+				}
 			}
+			else {
+				for (auto entityId : components) {
+					auto entity = Entity(entityId, manager);
+					callback(entity, components.get(entityId));
+				}
+			}
+		}
+
+		/**
+		* @brief Invokes the callback for every entity having the component, in parallel.
+		*
+		* Same contract as the multi-component version: only the components handed to the
+		* callback may be written, and no structural changes or messages are allowed.
+		*/
+		template <typename Lambda>
+		void parallelEach(ths::ThreadPool& pool, unsigned chunk, Lambda&& callback) {
+			auto entities = components.data();
+
+			pool.chunked(components.size(), chunk, [&](unsigned begin, unsigned end) {
+				for (auto index = begin; index < end; ++index) {
+					if (signatures && ((*signatures)[entities[index] & Entity::ID_MASK] & excluded).any()) continue;
+
+					auto entity = Entity(entities[index], manager);
+					callback(entity, components.at(index));
+				}
+			});
+		}
+
+		// Invokes the callback with spans over the whole dense arrays, split around the excluded entities
+		template <typename Lambda>
+		void eachChunk(Lambda&& callback) {
+			runs(0U, components.size(), callback);
+		}
+
+		template <typename Lambda>
+		void parallelEachChunk(ths::ThreadPool& pool, unsigned chunk, Lambda&& callback) {
+			pool.chunked(components.size(), chunk, [&](unsigned begin, unsigned end) {
+				runs(begin, end, callback);
+			});
+		}
+
+	private:
+		template <typename Lambda>
+		void runs(unsigned begin, unsigned end, Lambda& callback) {
+			static_assert(ComponentCollection<Component>::CONTIGUOUS, "Only contiguous storages can be spanned");
+
+			auto entities = components.data();
+			auto start = begin;
+
+			auto emit = [&](unsigned first, unsigned last) {
+				if (first < last) {
+					callback(Span<const Collection::Item>(entities + first, last - first), Span<Component>(components.raw() + first, last - first));
+				}
+			};
+
+			// Splits the positions around the excluded entities, if any
+			for (auto index = begin; signatures && index < end; ++index) {
+				if (((*signatures)[entities[index] & Entity::ID_MASK] & excluded).any()) {
+					emit(start, index);
+					start = index + 1U;
+				}
+			}
+
+			emit(start, end);
 		}
 
 	private:
 		EntityManager* manager;
 		ComponentCollection<Component>& components;
+		const std::pmr::vector<Signature>* signatures = nullptr; // Set once excluding
+		Signature excluded;
 	};
 }
 
@@ -1,12 +1,13 @@
 #pragma once
 
 #include "../../../Messages/Message.hpp"
+#include "../../Entity/Entity.h"
 
 template <typename Component>
 struct ComponentAdded final : public mqs::ManagedMessage<ComponentAdded<Component>>
 {
-	explicit ComponentAdded(const Component& component, unsigned entity) : mqs::ManagedMessage<ComponentAdded<Component>>(0U), component(component), entity(entity){}
+	explicit ComponentAdded(const Component& component, ecs::EntityId entity) : mqs::ManagedMessage<ComponentAdded<Component>>(0U), component(component), entity(entity){}
 
-	const unsigned entity;
+	const ecs::EntityId entity;
 	const Component& component;
 };
\ No newline at end of file
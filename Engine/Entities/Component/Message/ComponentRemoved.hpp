@@ -1,12 +1,13 @@
 #pragma once
 
 #include "../../../Messages/Message.hpp"
+#include "../../Entity/Entity.h"
 
 template <typename Component>
 struct ComponentRemoved final : public mqs::ManagedMessage<ComponentAdded<Component>>
 {
-	explicit ComponentRemoved(const Component& component, unsigned entity) : mqs::ManagedMessage<ComponentAdded<Component>>(0U), component(component), entity(entity){}
+	explicit ComponentRemoved(const Component& component, ecs::EntityId entity) : mqs::ManagedMessage<ComponentAdded<Component>>(0U), component(component), entity(entity){}
 
-	const unsigned entity;
+	const ecs::EntityId entity;
 	const Component& component;
 };
\ No newline at end of file
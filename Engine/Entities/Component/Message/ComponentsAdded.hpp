@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+#include "../../../Messages/Message.hpp"
+#include "../../Entity/Entity.h"
+
+// Published once per bulk assignment, instead of a ComponentAdded per entity
+template <typename Component>
+struct ComponentsAdded final : public mqs::ManagedMessage<ComponentsAdded<Component>>
+{
+	explicit ComponentsAdded(const std::vector<ecs::EntityId>& entities) : mqs::ManagedMessage<ComponentsAdded<Component>>(0U), entities(entities) {}
+
+	const std::vector<ecs::EntityId>& entities;
+};
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+
+#include "../../../Messages/Message.hpp"
+#include "../../Entity/Entity.h"
+
+// Published once per frame for batched components (see ComponentNotifications) and once per cleared collection, along with the removed components
+template <typename Component>
+struct ComponentsRemoved final : public mqs::ManagedMessage<ComponentsRemoved<Component>>
+{
+	explicit ComponentsRemoved(const std::vector<ecs::EntityId>& entities, const std::vector<Component>& components) : mqs::ManagedMessage<ComponentsRemoved<Component>>(0U), entities(entities), components(components) {}
+
+	const std::vector<ecs::EntityId>& entities;
+	const std::vector<Component>& components;
+};
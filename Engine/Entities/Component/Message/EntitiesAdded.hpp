@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+
+#include "../../../Messages/Message.hpp"
+#include "../../Entity/Entity.h"
+
+// Published once per bulk creation, instead of an EntityAdded per entity
+struct EntitiesAdded final : public mqs::ManagedMessage<EntitiesAdded>
+{
+	explicit EntitiesAdded(const std::vector<ecs::EntityId>& ids) : mqs::ManagedMessage<EntitiesAdded>(0U), entityIds(ids) {}
+
+	const std::vector<ecs::EntityId>& entityIds;
+};
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+
+#include "../../../Messages/Message.hpp"
+#include "../../Entity/Entity.h"
+
+// Published once per bulk destruction, instead of an EntityRemoved per entity
+struct EntitiesRemoved final : public mqs::ManagedMessage<EntitiesRemoved>
+{
+	explicit EntitiesRemoved(const std::vector<ecs::EntityId>& ids) : mqs::ManagedMessage<EntitiesRemoved>(0U), entityIds(ids) {}
+
+	const std::vector<ecs::EntityId>& entityIds;
+};
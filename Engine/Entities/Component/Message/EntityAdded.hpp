@@ -1,10 +1,11 @@
 #pragma once
 
 #include "../../../Messages/Message.hpp"
+#include "../../Entity/Entity.h"
 
 struct EntityAdded final : public mqs::ManagedMessage<EntityAdded>
 {
-	explicit EntityAdded(unsigned id) : mqs::ManagedMessage<EntityAdded>(0U), entityId(id) {}
+	explicit EntityAdded(ecs::EntityId id) : mqs::ManagedMessage<EntityAdded>(0U), entityId(id) {}
 
-	unsigned entityId;
+	ecs::EntityId entityId;
 };
\ No newline at end of file
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "../../../Messages/Message.hpp"
+#include "../../Entity/Entity.h"
 
 struct EntityRemoved final : public mqs::ManagedMessage<EntityRemoved>
 {
-	explicit EntityRemoved(unsigned entityId) : mqs::ManagedMessage<EntityRemoved>(0U), entityId(entityId) {}
+	explicit EntityRemoved(ecs::EntityId entityId) : mqs::ManagedMessage<EntityRemoved>(0U), entityId(entityId) {}
 
-	unsigned entityId;
+	ecs::EntityId entityId;
 };
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "../../../Messages/Message.hpp"
+
+// Published once a world snapshot is loaded, instead of any EntityAdded or ComponentAdded
+struct WorldLoaded final : public mqs::ManagedMessage<WorldLoaded>
+{
+	explicit WorldLoaded(unsigned entityCount) : mqs::ManagedMessage<WorldLoaded>(0U), entityCount(entityCount) {}
+
+	const unsigned entityCount;
+};
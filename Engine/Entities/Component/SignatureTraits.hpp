@@ -0,0 +1,28 @@
+#ifndef ECS_SIGNATURE_TRAITS_IMPL
+#define ECS_SIGNATURE_TRAITS_IMPL
+
+namespace ecs
+{
+	/**
+	* @brief Width of the component signatures of the entities.
+	*
+	* Component types whose identifier falls within the width are tracked by the
+	* signatures, the others are probed in their collections instead, which is slower and
+	* leaves them out of queries with exclusions. Specialize it to track more types. As with
+	* `EntityTraits`, the specialization must be visible before any other engine header,
+	* in every translation unit:
+	*
+	* @code
+	* #include "Engine/Entities/Component/SignatureTraits.hpp"
+	*
+	* template <> struct ecs::SignatureTraits<> { static constexpr unsigned BITS = 256U; };
+	* @endcode
+	*/
+	template <typename = void>
+	struct SignatureTraits
+	{
+		static constexpr unsigned BITS = 128U;
+	};
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef ENTITIES_COMPONENT_SPAN_IMPL
+#define ENTITIES_COMPONENT_SPAN_IMPL
+
+namespace ecs
+{
+	/**
+	* @brief Non-owning view over contiguous values, as handed to chunked iterations.
+	*
+	* @tparam Type Type of the values, const qualified for read-only views.
+	*/
+	template <typename Type>
+	class Span final
+	{
+	public:
+		Span(Type* values, unsigned count) : values(values), count(count) {}
+
+		Type* data() const {
+			return values;
+		}
+
+		unsigned size() const {
+			return count;
+		}
+
+		bool empty() const {
+			return count == 0U;
+		}
+
+		Type& operator[](unsigned index) const {
+			return values[index];
+		}
+
+		Type* begin() const {
+			return values;
+		}
+
+		Type* end() const {
+			return values + count;
+		}
+
+	private:
+		Type* values;
+		unsigned count;
+	};
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef ECS_COMMAND_BUFFER_DEF
+#define ECS_COMMAND_BUFFER_DEF
+
+#include <memory>
+#include <vector>
+
+#include "Entity.h"
+
+namespace ecs
+{
+	class EntityManager;
+
+	/**
+	* @brief Records structural changes to be played back later, in bulk.
+	*
+	* Creating or destroying entities and assigning or removing components while iterating
+	* may reorder the dense arrays being walked. Recording those changes instead, and playing
+	* them back at a sync point (see `EntityManager::flush`), makes them safe. Playback sorts
+	* the commands by entity and merges them: creations come first, then for every entity and
+	* component type the last assignment or removal recorded, and finally destructions.
+	*
+	* @note
+	* A buffer must only be used by a single thread (see `EntityManager::commands`).
+	*/
+	class CommandBuffer final
+	{
+	public:
+		// Handle of an entity whose creation has been recorded, only valid until the next playback
+		struct Deferred final
+		{
+			unsigned index;
+			unsigned generation; // Playbacks of the buffer before the creation, stale handles being rejected
+		};
+
+		CommandBuffer() = default;
+		CommandBuffer(const CommandBuffer&) = delete;
+		CommandBuffer(CommandBuffer&&) = default;
+
+		Deferred create();
+
+		void destroy(EntityId entityId);
+
+		template <typename Component, typename... Args>
+		void assign(EntityId entityId, Args&&... componentArgs);
+
+		template <typename Component, typename... Args>
+		void assign(Deferred entity, Args&&... componentArgs);
+
+		template <typename Component>
+		void remove(EntityId entityId);
+
+		template <typename Component>
+		void remove(Deferred entity);
+
+		bool empty() const;
+
+		// Drops every recorded command
+		void clear();
+
+		void playback(EntityManager& entities);
+
+	private:
+		// Entity as recorded: either an identifier or the index of a deferred creation
+		struct Target final
+		{
+			EntityId value;
+			bool deferred;
+		};
+
+		// Assignment or removal of a component, sequenced by its position in the queue
+		struct Command final
+		{
+			static constexpr unsigned REMOVAL = ~0U;
+
+			Target target;
+			unsigned component; // Index of the assigned component, or REMOVAL
+		};
+
+		// Commands recorded for a single component type
+		class Queue
+		{
+		public:
+			virtual ~Queue() = default;
+			virtual void apply(EntityManager& entities, const std::vector<EntityId>& created) = 0;
+			virtual bool empty() const = 0;
+		};
+
+		template <typename Component>
+		class ComponentQueue final : public Queue
+		{
+		public:
+			void apply(EntityManager& entities, const std::vector<EntityId>& created) override;
+			bool empty() const override;
+
+			std::vector<Command> commands;
+			std::vector<Component> components;
+		};
+
+		template <typename Component>
+		ComponentQueue<Component>& queue();
+
+		Target target(Deferred entity) const;
+
+		static EntityId resolve(const Target& target, const std::vector<EntityId>& created);
+
+	private:
+		unsigned creations = 0U;
+		unsigned generation = 0U;
+		std::vector<Target> destructions;
+		std::vector<std::unique_ptr<Queue>> queues; // Indexed by component identifier
+	};
+}
+
+#endif
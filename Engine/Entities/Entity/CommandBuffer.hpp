@@ -0,0 +1,176 @@
+#ifndef ECS_COMMAND_BUFFER_IMPL
+#define ECS_COMMAND_BUFFER_IMPL
+
+#include <numeric>
+#include <algorithm>
+
+#include "CommandBuffer.h"
+#include "EntityManager.h"
+#include "../../Family.hpp"
+
+namespace ecs
+{
+	inline CommandBuffer::Deferred CommandBuffer::create() {
+		return Deferred { creations++, generation };
+	}
+
+	inline void CommandBuffer::destroy(EntityId entityId) {
+		destructions.push_back({ entityId, false });
+	}
+
+	template <typename Component, typename... Args>
+	inline void CommandBuffer::assign(EntityId entityId, Args&&... componentArgs) {
+		auto& commands = queue<Component>();
+		commands.commands.push_back({ { entityId, false }, unsigned(commands.components.size()) });
+		commands.components.push_back(Component(std::forward<Args>(componentArgs)...));
+	}
+
+	template <typename Component, typename... Args>
+	inline void CommandBuffer::assign(Deferred entity, Args&&... componentArgs) {
+		auto deferred = target(entity);
+		auto& commands = queue<Component>();
+		commands.commands.push_back({ deferred, unsigned(commands.components.size()) });
+		commands.components.push_back(Component(std::forward<Args>(componentArgs)...));
+	}
+
+	template <typename Component>
+	inline void CommandBuffer::remove(EntityId entityId) {
+		queue<Component>().commands.push_back({ { entityId, false }, Command::REMOVAL });
+	}
+
+	template <typename Component>
+	inline void CommandBuffer::remove(Deferred entity) {
+		auto deferred = target(entity);
+		queue<Component>().commands.push_back({ deferred, Command::REMOVAL });
+	}
+
+	inline bool CommandBuffer::empty() const {
+		auto pending = [](const std::unique_ptr<Queue>& queue) { return queue && !queue->empty(); };
+		return !creations && destructions.empty() && std::none_of(queues.begin(), queues.end(), pending);
+	}
+
+	inline void CommandBuffer::clear() {
+		creations = 0U;
+		generation++;
+		destructions.clear();
+		queues.clear();
+	}
+
+	inline void CommandBuffer::playback(EntityManager& entities) {
+		// Messages published during the playback may record further commands, which are kept for the next one
+		auto recorded = std::move(queues);
+		auto destructing = std::move(destructions);
+		auto creating = creations;
+		auto created = std::vector<EntityId>();
+
+		queues.clear();
+		destructions.clear();
+		creations = 0U;
+		generation++;
+
+		if (creating) {
+			for (auto& entity : entities.create(creating)) {
+				created.push_back(entity.id());
+			}
+		}
+
+		for (auto& commands : recorded) {
+			if (commands) commands->apply(entities, created);
+		}
+
+		auto destroyed = std::vector<EntityId>();
+
+		for (auto& target : destructing) {
+			destroyed.push_back(resolve(target, created));
+		}
+
+		std::sort(destroyed.begin(), destroyed.end());
+		destroyed.erase(std::unique(destroyed.begin(), destroyed.end()), destroyed.end());
+
+		for (auto entityId : destroyed) {
+			if (entities.valid(entityId)) {
+				entities.destroy(entityId);
+			}
+		}
+	}
+
+	template <typename Component>
+	inline CommandBuffer::ComponentQueue<Component>& CommandBuffer::queue() {
+		auto uid = ComponentFamily::uid<Component>();
+
+		if (uid >= queues.size()) {
+			queues.resize(uid + 1U);
+		}
+
+		if (!queues[uid]) {
+			queues[uid] = std::make_unique<ComponentQueue<Component>>();
+		}
+
+		return static_cast<ComponentQueue<Component>&>(*queues[uid]);
+	}
+
+	inline CommandBuffer::Target CommandBuffer::target(Deferred entity) const {
+		if (entity.generation != generation || entity.index >= creations) {
+			throw "Invalid deferred entity";
+		}
+
+		return { entity.index, true };
+	}
+
+	inline EntityId CommandBuffer::resolve(const Target& target, const std::vector<EntityId>& created) {
+		return target.deferred ? created[target.value] : target.value;
+	}
+
+	template <typename Component>
+	inline void CommandBuffer::ComponentQueue<Component>::apply(EntityManager& entities, const std::vector<EntityId>& created) {
+		if (commands.empty()) {
+			return;
+		}
+
+		auto& collection = entities.collection<Component>();
+		auto ids = std::vector<EntityId>();
+		auto order = std::vector<unsigned>(commands.size());
+		auto added = std::vector<EntityId>();
+		auto components = std::vector<Component>();
+
+		for (auto& command : commands) {
+			ids.push_back(resolve(command.target, created));
+		}
+
+		// Sort by entity, keeping the recording order among the commands of the same entity
+		std::iota(order.begin(), order.end(), 0U);
+		std::stable_sort(order.begin(), order.end(), [&ids](unsigned left, unsigned right) { return ids[left] < ids[right]; });
+
+		for (auto position = 0U; position < order.size(); ++position) {
+			auto& command = commands[order[position]];
+			auto entityId = ids[order[position]];
+			auto last = position + 1U == order.size() || ids[order[position + 1U]] != entityId; // The last command wins
+
+			if (!last || !entities.valid(entityId)) {
+				continue;
+			}
+
+			if (command.component == Command::REMOVAL) {
+				collection.reset(entityId);
+			}
+			else if (collection.contains(entityId)) {
+				collection.replace(entityId, this->components[command.component]);
+			}
+			else {
+				added.push_back(entityId);
+				components.push_back(std::move(this->components[command.component]));
+			}
+		}
+
+		collection.add(added, components);
+		commands.clear();
+		this->components.clear();
+	}
+
+	template <typename Component>
+	inline bool CommandBuffer::ComponentQueue<Component>::empty() const {
+		return commands.empty();
+	}
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef ECS_COUNTING_RESOURCE_IMPL
+#define ECS_COUNTING_RESOURCE_IMPL
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace ecs
+{
+	/**
+	* @brief Memory resource counting the calls forwarded to another resource.
+	*
+	* Put it upstream of the resource of a world to check how often its storage (entities,
+	* signatures, sparse sets and components) reaches the heap. Only that storage draws from
+	* the resource: scheduling systems, playing back command buffers and publishing messages
+	* still use the global heap, and aren't counted.
+	*
+	* Systems running concurrently add and remove components concurrently, hence the resource
+	* of a world must be thread-safe, e.g. `std::pmr::synchronized_pool_resource`. Resources
+	* which aren't (`std::pmr::monotonic_buffer_resource`, `std::pmr::unsynchronized_pool_resource`)
+	* only fit worlds whose workers have a single thread:
+	*
+	* @code
+	* auto heap = ecs::CountingResource();
+	* auto pool = std::pmr::synchronized_pool_resource(&heap);
+	* auto entities = ecs::EntityManager(messages, &pool);
+	*
+	* auto before = heap.allocations();
+	* systems.update(delta);
+	* auto grown = heap.allocations() - before; // Storage growth of the frame
+	* @endcode
+	*/
+	class CountingResource final : public std::pmr::memory_resource
+	{
+	public:
+		explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) : upstream(upstream) {}
+		CountingResource(const CountingResource&) = delete;
+
+		unsigned allocations() const {
+			return allocated.load(std::memory_order_relaxed);
+		}
+
+		unsigned deallocations() const {
+			return deallocated.load(std::memory_order_relaxed);
+		}
+
+		// Bytes currently allocated through this resource
+		std::size_t bytes() const {
+			return held.load(std::memory_order_relaxed);
+		}
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			auto memory = upstream->allocate(bytes, alignment);
+			allocated.fetch_add(1U, std::memory_order_relaxed);
+			held.fetch_add(bytes, std::memory_order_relaxed);
+			return memory;
+		}
+
+		void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override {
+			upstream->deallocate(memory, bytes, alignment);
+			deallocated.fetch_add(1U, std::memory_order_relaxed);
+			held.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+	private:
+		std::pmr::memory_resource* upstream;
+		std::atomic<unsigned> allocated = 0U;
+		std::atomic<unsigned> deallocated = 0U;
+		std::atomic<std::size_t> held = 0U;
+	};
+}
+
+#endif
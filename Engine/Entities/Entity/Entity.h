@@ -1,26 +1,37 @@
 #ifndef ECS_ENTITY_DEF
 #define ECS_ENTITY_DEF
 
+#include "EntityTraits.hpp"
+
 namespace ecs
 {
+	using EntityId = EntityTraits<>::Id; // Fixes the layout, hence no specialization past this point
+
 	class EntityManager;
 
-	class Entity final
+	/**
+	* @brief Handle of an entity, forwarding to the manager (backend) which owns it.
+	*/
+	template <typename Manager>
+	class BasicEntity final
 	{
 	public:
-		static const int ID_MASK = 0xFFFFFF;
-		static const int VERSION_MASK = 0xFF;
-		static const int VERSION_SHIFT = 24;
+		static constexpr EntityId ID_MASK = EntityTraits<>::ID_MASK;
+		static constexpr EntityId VERSION_MASK = EntityTraits<>::VERSION_MASK;
+		static constexpr unsigned VERSION_SHIFT = EntityTraits<>::VERSION_SHIFT;
 
-		Entity() = delete;
-		Entity(const Entity&) = default;
-		Entity(unsigned id, EntityManager* manager);
+		BasicEntity() = delete;
+		BasicEntity(const BasicEntity&) = default;
+		BasicEntity(EntityId id, Manager* manager);
 
-		unsigned id() const;
-		unsigned version() const;
+		EntityId id() const;
+		EntityId version() const;
 
 		template <typename Component>
-		Component& component() const;
+		decltype(auto) component() const;
+
+		template <typename Component, typename Function>
+		void patch(Function&& function) const;
 
 		template <typename Component, typename... Args>
 		Component assign(Args&&... args) const;
@@ -61,15 +72,17 @@ namespace ecs
 		void destroy();
 		bool valid() const;
 
-		bool operator==(const Entity& other) const;
-		bool operator!=(const Entity& other) const;
+		bool operator==(const BasicEntity& other) const;
+		bool operator!=(const BasicEntity& other) const;
 
 		operator bool() const;
 
 	private:
-		unsigned identifier;
-		EntityManager* manager;
+		EntityId identifier;
+		Manager* manager;
 	};
+
+	using Entity = BasicEntity<EntityManager>;
 }
 
 #endif
\ No newline at end of file
@@ -6,101 +6,128 @@
 
 namespace ecs
 {
-	inline Entity::Entity(unsigned id, EntityManager* manager) {
+	template <typename Manager>
+	inline BasicEntity<Manager>::BasicEntity(EntityId id, Manager* manager) {
 		this->identifier = id;
 		this->manager = manager;
 	}
 
-	inline unsigned Entity::id() const {
+	template <typename Manager>
+	inline EntityId BasicEntity<Manager>::id() const {
 		return identifier;
 	}
 
-	inline unsigned Entity::version() const {
+	template <typename Manager>
+	inline EntityId BasicEntity<Manager>::version() const {
 		return manager->current(identifier);
 	}
 
+	template <typename Manager>
 	template <typename Component>
-	inline Component& Entity::component() const {
-		return manager->component<Component>(identifier);
+	inline decltype(auto) BasicEntity<Manager>::component() const {
+		return manager->template component<Component>(identifier);
 	}
 
+	template <typename Manager>
+	template <typename Component, typename Function>
+	inline void BasicEntity<Manager>::patch(Function&& function) const {
+		manager->template patch<Component>(identifier, std::forward<Function>(function));
+	}
+
+	template <typename Manager>
 	template <typename Component, typename... Args>
-	inline Component Entity::assign(Args&&... args) const {
-		return manager->assign<Component>(identifier, args...);
+	inline Component BasicEntity<Manager>::assign(Args&&... args) const {
+		return manager->template assign<Component>(identifier, args...);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Args>
-	inline Component Entity::replace(Args&&... args) const {
-		return manager->replace<Component>(identifier, args...);
+	inline Component BasicEntity<Manager>::replace(Args&&... args) const {
+		return manager->template replace<Component>(identifier, args...);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Args>
-	inline Component Entity::save(Args&&... args) const {
-		return manager->save<Component>(identifier, args...);
+	inline Component BasicEntity<Manager>::save(Args&&... args) const {
+		return manager->template save<Component>(identifier, args...);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline void Entity::assign(const Component& component, const Components&... components) const {
+	inline void BasicEntity<Manager>::assign(const Component& component, const Components&... components) const {
 		manager->assign(identifier, component, components...);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline void Entity::replace(const Component& component, const Components&... components) const {
+	inline void BasicEntity<Manager>::replace(const Component& component, const Components&... components) const {
 		manager->replace(identifier, component, components...);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline void Entity::save(const Component& component, const Components&... components) const {
+	inline void BasicEntity<Manager>::save(const Component& component, const Components&... components) const {
 		manager->save(identifier, component, components...);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline void Entity::reset(const Component* unused, const Components*... unuseds) {
-		manager->reset<Component, Components...>(identifier);
+	inline void BasicEntity<Manager>::reset(const Component* unused, const Components*... unuseds) {
+		manager->template reset<Component, Components...>(identifier);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline void Entity::reset() {
-		manager->reset<Component, Components...>(identifier);
+	inline void BasicEntity<Manager>::reset() {
+		manager->template reset<Component, Components...>(identifier);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline void Entity::remove(const Component* unused, const Components*... unuseds) {
-		manager->remove<Component, Components...>(identifier);
+	inline void BasicEntity<Manager>::remove(const Component* unused, const Components*... unuseds) {
+		manager->template remove<Component, Components...>(identifier);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline void Entity::remove() {
-		manager->remove<Component, Components...>(identifier);
+	inline void BasicEntity<Manager>::remove() {
+		manager->template remove<Component, Components...>(identifier);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline bool Entity::has() const {
-		return manager->has<Component, Components...>(identifier);
+	inline bool BasicEntity<Manager>::has() const {
+		return manager->template has<Component, Components...>(identifier);
 	}
 
+	template <typename Manager>
 	template <typename Component, typename... Components>
-	inline bool Entity::has(const Component* unused, const Components*... unuseds) const {
-		return manager->has<Component, Components...>(identifier);
+	inline bool BasicEntity<Manager>::has(const Component* unused, const Components*... unuseds) const {
+		return manager->template has<Component, Components...>(identifier);
 	}
 
-	inline void Entity::destroy() {
+	template <typename Manager>
+	inline void BasicEntity<Manager>::destroy() {
 		manager->destroy(identifier);
 	}
 
-	inline bool Entity::valid() const {
+	template <typename Manager>
+	inline bool BasicEntity<Manager>::valid() const {
 		return manager->valid(identifier);
 	}
 
-	inline bool Entity::operator==(const Entity& other) const {
+	template <typename Manager>
+	inline bool BasicEntity<Manager>::operator==(const BasicEntity& other) const {
 		return identifier == other.identifier;
 	}
 
-	inline bool Entity::operator!=(const Entity& other) const {
+	template <typename Manager>
+	inline bool BasicEntity<Manager>::operator!=(const BasicEntity& other) const {
 		return identifier != other.identifier;
 	}
 
-	inline Entity::operator bool() const {
+	template <typename Manager>
+	inline BasicEntity<Manager>::operator bool() const {
 		return manager->valid(identifier);
 	}
 }
@@ -1,90 +1,209 @@
 #ifndef ECS_ENTITY_MANAGER_DEF
 #define ECS_ENTITY_MANAGER_DEF
 
+#include <mutex>
+#include <atomic>
 #include <memory>
-
+#include <thread>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <memory_resource>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Entity.h"
+#include "CommandBuffer.h"
+#include "../../Threads/ThreadPool.hpp"
 #include "../Component/ComponentView.hpp"
+#include "../Component/ComponentFilter.hpp"
 #include "../Component/Message/EntityAdded.hpp"
+#include "../Component/Message/EntitiesAdded.hpp"
 #include "../Component/Message/EntityRemoved.hpp"
+#include "../Component/Message/EntitiesRemoved.hpp"
+#include "../Component/Message/WorldLoaded.hpp"
 
 namespace ecs
 {
-	class Entity;
-
 	class EntityManager final
 	{
 	public:
-		EntityManager(const std::shared_ptr<mqs::MessageManager>& messages);
+		// Every array of the world (entities, signatures, sparse sets and components) draws from the resource,
+		// which must be thread-safe as concurrent systems share it (see `CountingResource`), parallel iterations
+		// and systems run on the given workers (the pool shared by default across worlds)
+		EntityManager(const std::shared_ptr<mqs::MessageManager>& messages, std::pmr::memory_resource* resource = std::pmr::get_default_resource(), const std::shared_ptr<ths::ThreadPool>& workers = ths::ThreadPool::shared());
 		EntityManager(const EntityManager&) = delete;
-		EntityManager(EntityManager&&) = default;
+		EntityManager(EntityManager&&) = delete; // Entities and views point to their manager
 
 		EntityManager& operator=(const EntityManager&) = delete;
-		EntityManager& operator=(EntityManager&&) = default;
+		EntityManager& operator=(EntityManager&&) = delete;
 
 		Entity create();
 
 		template <typename Component, typename... Args>
 		Entity create(Args&&... componentArgs);
 
-		template <typename Component, typename... Components>
+		template <typename Component, typename... Components, typename = std::enable_if_t<!std::is_integral<Component>::value>>
 		Entity create(const Component& component, const Components&... components);
 
+		template <typename... Components>
+		std::vector<Entity> create(unsigned count, const Components&... components);
+
 		template <typename Component, typename... Args>
-		Component assign(unsigned entityId, Args&&... componentArgs);
+		Component assign(EntityId entityId, Args&&... componentArgs);
 
 		template <typename Component, typename... Args>
-		Component replace(unsigned entityId, Args&&... componentArgs);
+		Component replace(EntityId entityId, Args&&... componentArgs);
 
 		template <typename Component, typename... Args>
-		Component save(unsigned entityId, Args&&... componentArgs);
+		Component save(EntityId entityId, Args&&... componentArgs);
 
 		template <typename Component>
-		Component& component(unsigned entityId);
+		ComponentReference<Component> component(EntityId entityId);
+
+		// Applies the function to the component in place and marks it as changed
+		template <typename Component, typename Function>
+		void patch(EntityId entityId, Function&& function);
+
+		// Marks the component as changed, as writes through references are not tracked
+		template <typename Component>
+		void touch(EntityId entityId);
 
 		template <typename Component, typename... Components>
-		void assign(unsigned entityId, const Component& component, const Components&... components);
+		void assign(EntityId entityId, const Component& component, const Components&... components);
+
+		template <typename Iterator, typename Component, typename... Components>
+		void assign(Iterator first, Iterator last, const Component& component, const Components&... components);
 
 		template <typename Component, typename... Components>
-		void replace(unsigned entityId, const Component& component, const Components&... components);
+		void replace(EntityId entityId, const Component& component, const Components&... components);
 
 		template <typename Component, typename... Components>
-		void save(unsigned entityId, const Component& component, const Components&... components);
+		void save(EntityId entityId, const Component& component, const Components&... components);
 
 		template <typename Component, typename... Components>
-		void reset(unsigned entityId);
+		void reset(EntityId entityId);
 
 		template <typename Component, typename... Components>
-		void reset(unsigned entityId, const Component&, const Components&...);
+		void reset(EntityId entityId, const Component&, const Components&...);
 
 		template <typename Component, typename... Components>
 		void reset();
 
 		template <typename Component, typename... Components>
-		void remove(unsigned entityId);
+		void remove(EntityId entityId);
 
 		template <typename Component, typename... Components>
-		void remove(unsigned entityId, const Component&, const Components&...);
+		void remove(EntityId entityId, const Component&, const Components&...);
 
 		template <typename Component, typename... Components>
-		bool has(unsigned entityId);
+		bool has(EntityId entityId);
 
+		// Components may be wrapped in query filters, e.g. each<Changed<Transform>, Body>(...)
 		template <typename Component, typename... Components, typename Lambda>
 		void each(Lambda&& lambda);
 
+		// Skips the entities having any of the excluded components, e.g. each<Motion>(exclude<Joystick>, ...)
+		template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+		void each(Exclude<Excluded...>, Lambda&& lambda);
+
 		template <typename Lambda>
 		void each(Lambda&& lambda);
 
+		// Visits entities from the worker threads: callbacks may only write the components they are
+		// handed, and must not change the structure, touch other entities or publish messages
+		template <typename Component, typename... Components, typename Lambda>
+		void parallelEach(Lambda&& lambda, unsigned chunk = 0U);
+
+		template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+		void parallelEach(Exclude<Excluded...>, Lambda&& lambda, unsigned chunk = 0U);
+
+		// Visits the entities as runs of spans over the dense arrays, e.g. eachChunk<Transform, Motion>(
+		// [](Span<const EntityId> entities, Span<Transform> transforms, Span<Motion> motions) {}), see ComponentView
+		template <typename Component, typename... Components, typename Lambda>
+		void eachChunk(Lambda&& lambda);
+
+		template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+		void eachChunk(Exclude<Excluded...>, Lambda&& lambda);
+
+		// Same contract as 'parallelEach', runs being split into chunks of the given size
+		template <typename Component, typename... Components, typename Lambda>
+		void parallelEachChunk(Lambda&& lambda, unsigned chunk = 0U);
+
+		template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+		void parallelEachChunk(Exclude<Excluded...>, Lambda&& lambda, unsigned chunk = 0U);
+
 		template <typename Component>
 		unsigned count();
 
+		template <typename... Components>
+		void prepare();
+
+		template <typename Component>
+		ComponentCollection<Component>& collection();
+
+		// Sorts the entities having the component (thus the iterations over them) by the component
+		template <typename Component, typename Compare>
+		void sort(Compare compare, Collection::Sorting sorting = Collection::Sorting::Full);
+
+		// Orders the entities having the component as the ones having the other component
+		template <typename Component, typename Other>
+		void respect();
+
+		// Command buffer of the calling thread, whose structural changes are applied on 'flush'
+		CommandBuffer& commands();
+
+		// Plays back the command buffers of every thread, then publishes the batched notifications
+		void flush();
+
+		template <typename Component, typename... Components>
+		const ComponentGroup& group();
+
+		// World-wide singleton of the given type (e.g. the wind), default constructed on first access. Registered
+		// contexts (see Registry<ContextFamily>) are constructed with the world and resolved with a constant index
+		template <typename Context>
+		Context& context();
+
+		// Writes the whole world (entities, clock, components and their ticks) as a binary snapshot
+		void snapshot(std::ostream& stream);
+
+		// Replaces the whole world by a snapshot, publishing nothing. The components it holds must have the same
+		// identifiers as when written, hence be registered, or prepared in the same order as back then
+		void restore(std::istream& stream);
+
+		// Restores a snapshot file through a memory mapping, then publishes a single WorldLoaded. Components stored
+		// in a `MappedStorage` are used in place from the mapping, paged in as accessed, the others being copied
+		void load(const std::string& path);
+
 		unsigned size() const;
 
-		unsigned version(unsigned entityId) const;
-		unsigned current(unsigned entityId) const;
+		ths::ThreadPool& workers() const;
+
+		std::pmr::memory_resource* memory() const;
+
+		// Current tick of the world clock, recorded by components as they are added or changed
+		unsigned tick() const;
 
-		bool valid(unsigned entityId) const;
+		// Starts a new tick and returns it
+		unsigned advance();
 
-		void destroy(unsigned entityId);
+		// Sets the tick after which filters report changes on the calling thread, returning the previous one
+		unsigned observe(unsigned since);
+
+		EntityId version(EntityId entityId) const;
+		EntityId current(EntityId entityId) const;
+
+		bool valid(EntityId entityId) const;
+
+		void destroy(EntityId entityId);
+
+		// Destroys every entity having all the components, publishing a single EntitiesRemoved
+		template <typename Component, typename... Components>
+		void destroyAll();
+
+		// Destroys every entity, publishing a single ComponentsRemoved per collection and EntitiesRemoved
+		void clear();
 
 	private:
 		template <typename Component>
@@ -96,8 +215,42 @@ namespace ecs
 		template <typename Component>
 		bool managed() const;
 
-		template <bool = true>
-		bool has(unsigned entityId);
+		template <typename Component>
+		void allocate();
+
+		template <typename... Components>
+		void preallocate(TypeList<Components...>);
+
+		template <typename Context>
+		void allocateContext();
+
+		template <typename... Contexts>
+		void preallocateContexts(TypeList<Contexts...>);
+
+		// Calls the function with the identifier of every component type of the signature
+		template <typename Function>
+		static void visit(const Signature& signature, Function&& function);
+
+		// Calls the function with the identifier of every collection beyond the signatures, which has to be probed
+		template <typename Function>
+		void untracked(Function&& function);
+
+		// Rebuilds the free list from the entities, in a single pass
+		void relink();
+
+		// Bits of the given component types within the signatures, none if any of them can't be managed
+		template <typename... Components>
+		static const Signature& signature();
+
+		// Bits of the given excluded component types, which must be within the signatures
+		template <typename... Components>
+		static Signature exclusion();
+
+		// Visits the entities matching the queries, driven by the ticks of the first filtered collection
+		template <typename... Queries, typename Lambda>
+		void filter(Lambda& lambda, ths::ThreadPool* workers, unsigned chunk = 0U, const Signature& excluded = Signature());
+
+		static unsigned& observed();
 
 		template <bool = true>
 		bool empty() const;
@@ -106,25 +259,48 @@ namespace ecs
 		void reset();
 
 		template <bool = true>
-		void remove(unsigned entityId);
+		void remove(EntityId entityId);
 
 		template <bool = true>
-		void reset(unsigned entityId);
+		void reset(EntityId entityId);
 
-		void assign(unsigned entityId);
+		void assign(EntityId entityId);
 
-		void replace(unsigned entityId);
+		template <typename Component, typename... Components>
+		void assign(const std::vector<EntityId>& entityIds, const Component& component, const Components&... components);
+
+		void assign(const std::vector<EntityId>& entityIds);
+
+		EntityId generate();
+
+		static EntityId identifier(EntityId entityId);
 
-		void save(unsigned entityId);
+		static EntityId identifier(const Entity& entity);
 
-		void validate(unsigned entityId);
+		void replace(EntityId entityId);
+
+		void save(EntityId entityId);
+
+		void validate(EntityId entityId);
 
 	private:
-		unsigned next = 0U;
+		static constexpr unsigned SNAPSHOT_MAGIC = 0x53534345U; // "ECSS"
+		static constexpr unsigned SNAPSHOT_VERSION = 2U;
+		static constexpr unsigned SNAPSHOT_LAYOUT = unsigned(sizeof(EntityId)) << 8U | Entity::VERSION_SHIFT; // Width and index bits of the identifiers
+
+		EntityId next = 0U;
 		unsigned available = 0U;
-		std::vector<unsigned> entities;
+		std::pmr::vector<EntityId> entities;
 		std::vector<std::unique_ptr<Collection>> collections;
+		std::vector<std::unique_ptr<ComponentGroup>> groups; // Must be destroyed before the collections they own
+		std::vector<std::shared_ptr<void>> contexts; // Indexed by context identifier, kept as the world is cleared or restored
 		std::shared_ptr<mqs::MessageManager> messages;
+		std::shared_ptr<ths::ThreadPool> pool;
+		std::shared_ptr<std::atomic<unsigned>> clock; // Starts at one, so that filters report everything to systems never run
+		std::shared_ptr<std::pmr::vector<Signature>> signatures; // Component types of each entity, kept up to date by the collections
+		std::pmr::memory_resource* resource;
+		std::mutex buffersMutex;
+		std::unordered_map<std::thread::id, std::unique_ptr<CommandBuffer>> buffers;
 	};
 }
 
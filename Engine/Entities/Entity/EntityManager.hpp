@@ -2,35 +2,31 @@
 #define ECS_ENTITY_MANAGER_IMPL
 
 #include <cassert>
+#include <algorithm>
 
 #include "EntityManager.h"
 #include "Entity.h"
+#include "CommandBuffer.hpp"
+#include "MappedSnapshot.hpp"
 #include "../../Family.hpp"
 
 namespace ecs
 {
-	inline EntityManager::EntityManager(const std::shared_ptr<mqs::MessageManager>& messages) : messages(messages) {
+	inline EntityManager::EntityManager(const std::shared_ptr<mqs::MessageManager>& messages, std::pmr::memory_resource* resource, const std::shared_ptr<ths::ThreadPool>& workers) : entities(resource), messages(messages), pool(workers), clock(std::make_shared<std::atomic<unsigned>>(1U)), signatures(std::make_shared<std::pmr::vector<Signature>>(resource)), resource(resource) {
 		next = 0U;
 		available = 0U;
-	}
 
-	inline Entity EntityManager::create() {
-		unsigned id = 0U;
+		// Registered component types get their collections upfront
+		collections.reserve(Registry<ComponentFamily>::types::size);
+		preallocate(Registry<ComponentFamily>::types());
 
-		if (available) {
-			auto entity = next;
-			auto version = entities[entity] & ~Entity::ID_MASK;
+		// Likewise for registered contexts, which are then never allocated lazily
+		contexts.reserve(Registry<ContextFamily>::types::size);
+		preallocateContexts(Registry<ContextFamily>::types());
+	}
 
-			id = entity | version;
-			next = entities[entity] & Entity::ID_MASK;
-			entities[entity] = id;
-			available--;
-		}
-		else {
-			id = entities.size();
-			assert(id < Entity::ID_MASK);
-			entities.push_back(id);
-		}
+	inline Entity EntityManager::create() {
+		auto id = generate();
 
 		messages->publish<EntityAdded>(id);
 
@@ -44,15 +40,36 @@ namespace ecs
 		return entity;
 	}
 
-	template <typename Component, typename... Components>
+	template <typename Component, typename... Components, typename>
 	inline Entity EntityManager::create(const Component& component, const Components&... components) {
 		auto entity = create();
 		entity.assign(component, components...);
 		return entity;
 	}
 
+	template <typename... Components>
+	inline std::vector<Entity> EntityManager::create(unsigned count, const Components&... components) {
+		auto ids = std::vector<EntityId>();
+		auto created = std::vector<Entity>();
+
+		ids.reserve(count);
+		created.reserve(count);
+		entities.reserve(entities.size() + count - std::min(count, available));
+		signatures->reserve(entities.capacity());
+
+		for (auto index = 0U; index < count; ++index) {
+			ids.push_back(generate());
+			created.emplace_back(ids.back(), this);
+		}
+
+		messages->publish<EntitiesAdded>(ids);
+		assign(ids, components...);
+
+		return created;
+	}
+
 	template <typename Component, typename... Args>
-	inline Component EntityManager::assign(unsigned entityId, Args&&... componentArgs) {
+	inline Component EntityManager::assign(EntityId entityId, Args&&... componentArgs) {
 		validate(entityId);
 		auto component = Component(std::forward<Args>(componentArgs)...);
 		safeCollection<Component>().add(entityId, component);
@@ -60,7 +77,7 @@ namespace ecs
 	}
 
 	template <typename Component, typename... Args>
-	inline Component EntityManager::replace(unsigned entityId, Args&&... componentArgs) {
+	inline Component EntityManager::replace(EntityId entityId, Args&&... componentArgs) {
 		validate(entityId);
 		auto component = Component(std::forward<Args>(componentArgs)...);
 		unsafeCollection<Component>().replace(entityId, component);
@@ -68,7 +85,7 @@ namespace ecs
 	}
 
 	template <typename Component, typename... Args>
-	inline Component EntityManager::save(unsigned entityId, Args&&... componentArgs) {
+	inline Component EntityManager::save(EntityId entityId, Args&&... componentArgs) {
 		validate(entityId);
 		auto component = Component(std::forward<Args>(componentArgs)...);
 		safeCollection<Component>().save(entityId, component);
@@ -76,34 +93,60 @@ namespace ecs
 	}
 
 	template <typename Component>
-	inline Component& EntityManager::component(unsigned entityId) {
+	inline ComponentReference<Component> EntityManager::component(EntityId entityId) {
 		validate(entityId);
 		return unsafeCollection<Component>().get(entityId);
 	}
 
+	template <typename Component, typename Function>
+	inline void EntityManager::patch(EntityId entityId, Function&& function) {
+		validate(entityId);
+		auto& collection = unsafeCollection<Component>();
+		function(collection.get(entityId));
+		collection.touch(entityId);
+	}
+
+	template <typename Component>
+	inline void EntityManager::touch(EntityId entityId) {
+		validate(entityId);
+		unsafeCollection<Component>().touch(entityId);
+	}
+
 	template <typename Component, typename... Components>
-	inline void EntityManager::assign(unsigned entityId, const Component& component, const Components&... components) {
+	inline void EntityManager::assign(EntityId entityId, const Component& component, const Components&... components) {
 		validate(entityId);
 		safeCollection<Component>().add(entityId, component);
 		assign(entityId, components...);
 	}
 
+	template <typename Iterator, typename Component, typename... Components>
+	inline void EntityManager::assign(Iterator first, Iterator last, const Component& component, const Components&... components) {
+		auto ids = std::vector<EntityId>();
+
+		for (auto iterator = first; iterator != last; ++iterator) {
+			ids.push_back(identifier(*iterator));
+			validate(ids.back());
+		}
+
+		assign(ids, component, components...);
+	}
+
 	template <typename Component, typename... Components>
-	inline void EntityManager::replace(unsigned entityId, const Component& component, const Components&... components) {
+	inline void EntityManager::replace(EntityId entityId, const Component& component, const Components&... components) {
 		validate(entityId);
 		unsafeCollection<Component>().replace(entityId, component);
 		replace(entityId, components...);
 	}
 
 	template <typename Component, typename... Components>
-	inline void EntityManager::save(unsigned entityId, const Component& component, const Components&... components) {
+	inline void EntityManager::save(EntityId entityId, const Component& component, const Components&... components) {
 		validate(entityId);
 		safeCollection<Component>().save(entityId, component);
 		save(entityId, components...);
 	}
 
 	template <typename Component, typename... Components>
-	inline void EntityManager::reset(unsigned entityId) {
+	inline void EntityManager::reset(EntityId entityId) {
 		validate(entityId);
 
 		if (managed<Component>()) {
@@ -114,51 +157,117 @@ namespace ecs
 	}
 
 	template <typename Component, typename... Components>
-	inline void EntityManager::reset(unsigned entityId, const Component&, const Components&...) {
+	inline void EntityManager::reset(EntityId entityId, const Component&, const Components&...) {
 		reset<Component, Components...>(entityId);
 	}
 
 	template <typename Component, typename... Components>
 	inline void EntityManager::reset() {
 		if (managed<Component>()) {
-			auto& collection = unsafeCollection<Component>();
-
-			each([&collection](Entity& entity) {
-				collection.reset(entity.id());
-			});
+			unsafeCollection<Component>().clear();
 		}
 
 		reset<Components...>();
 	}
 
 	template <typename Component, typename... Components>
-	inline void EntityManager::remove(unsigned entityId) {
+	inline void EntityManager::remove(EntityId entityId) {
 		validate(entityId);
 		unsafeCollection<Component>().remove(entityId);
 		remove<Components...>(entityId);
 	}
 
 	template <typename Component, typename... Components>
-	inline void EntityManager::remove(unsigned entityId, const Component&, const Components&...) {
+	inline void EntityManager::remove(EntityId entityId, const Component&, const Components&...) {
 		remove<Component, Components...>(entityId);
 	}
 
 	template <typename Component, typename... Components>
-	inline bool EntityManager::has(unsigned entityId) {
+	inline bool EntityManager::has(EntityId entityId) {
 		validate(entityId);
-		return managed<Component>() && unsafeCollection<Component>().contains(entityId) && has<Components...>(entityId);
+
+		auto& mask = signature<Component, Components...>();
+
+		if (mask.none()) {
+			// Some of the types are beyond the signatures, if managed at all
+			return (managed<Component>() && unsafeCollection<Component>().contains(entityId)) && (... && (managed<Components>() && unsafeCollection<Components>().contains(entityId)));
+		}
+
+		return ((*signatures)[entityId & Entity::ID_MASK] & mask) == mask;
 	}
 
 	template <typename Component, typename... Components, typename Lambda>
 	inline void EntityManager::each(Lambda&& lambda) {
-		auto function = std::function<void(Entity&, Component&, Components&...)>(std::move(lambda));
-		ComponentView<Component, Components...>(this, safeCollection<Component>(), safeCollection<Components>()...).each(function);
+		if constexpr (filtering<Component, Components...>()) {
+			filter<Component, Components...>(lambda, nullptr);
+		}
+		else {
+			ComponentView<Component, Components...>(this, safeCollection<Component>(), safeCollection<Components>()...).each(lambda);
+		}
+	}
+
+	template <typename Component, typename... Components, typename Lambda>
+	inline void EntityManager::parallelEach(Lambda&& lambda, unsigned chunk) {
+		if constexpr (filtering<Component, Components...>()) {
+			filter<Component, Components...>(lambda, pool.get(), chunk);
+		}
+		else {
+			ComponentView<Component, Components...>(this, safeCollection<Component>(), safeCollection<Components>()...).parallelEach(*pool, chunk, lambda);
+		}
+	}
+
+	template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+	inline void EntityManager::each(Exclude<Excluded...>, Lambda&& lambda) {
+		auto excluded = exclusion<Excluded...>();
+
+		if constexpr (filtering<Component, Components...>()) {
+			filter<Component, Components...>(lambda, nullptr, 0U, excluded);
+		}
+		else {
+			ComponentView<Component, Components...>(this, safeCollection<Component>(), safeCollection<Components>()...).exclude(excluded).each(lambda);
+		}
+	}
+
+	template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+	inline void EntityManager::parallelEach(Exclude<Excluded...>, Lambda&& lambda, unsigned chunk) {
+		auto excluded = exclusion<Excluded...>();
+
+		if constexpr (filtering<Component, Components...>()) {
+			filter<Component, Components...>(lambda, pool.get(), chunk, excluded);
+		}
+		else {
+			ComponentView<Component, Components...>(this, safeCollection<Component>(), safeCollection<Components>()...).exclude(excluded).parallelEach(*pool, chunk, lambda);
+		}
+	}
+
+	template <typename Component, typename... Components, typename Lambda>
+	inline void EntityManager::eachChunk(Lambda&& lambda) {
+		eachChunk<Component, Components...>(Exclude<>(), lambda);
+	}
+
+	template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+	inline void EntityManager::eachChunk(Exclude<Excluded...>, Lambda&& lambda) {
+		static_assert(!filtering<Component, Components...>(), "Filtered queries can't be spanned");
+
+		auto excluded = exclusion<Excluded...>();
+		ComponentView<Component, Components...>(this, safeCollection<Component>(), safeCollection<Components>()...).exclude(excluded).eachChunk(lambda);
+	}
+
+	template <typename Component, typename... Components, typename Lambda>
+	inline void EntityManager::parallelEachChunk(Lambda&& lambda, unsigned chunk) {
+		parallelEachChunk<Component, Components...>(Exclude<>(), lambda, chunk);
+	}
+
+	template <typename Component, typename... Components, typename... Excluded, typename Lambda>
+	inline void EntityManager::parallelEachChunk(Exclude<Excluded...>, Lambda&& lambda, unsigned chunk) {
+		static_assert(!filtering<Component, Components...>(), "Filtered queries can't be spanned");
+
+		auto excluded = exclusion<Excluded...>();
+		ComponentView<Component, Components...>(this, safeCollection<Component>(), safeCollection<Components>()...).exclude(excluded).parallelEachChunk(*pool, chunk, lambda);
 	}
 
 	template <typename Lambda>
 	inline void EntityManager::each(Lambda&& lambda) {
-		auto function = std::function<void(Entity&)>(std::move(lambda));
-
 		if (available) {
 			for (auto entityId : entities) {
 				auto clone = entityId; // Needed?
@@ -166,14 +275,14 @@ namespace ecs
 
 				if (entityId == masked) {
 					auto entity = Entity(entityId, this);
-					function(entity);
+					lambda(entity);
 				}
 			}
 		}
 		else {
 			for (auto entityId : entities) {
 				auto entity = Entity(entityId, this);
-				function(entity);
+				lambda(entity);
 			}
 		}
 	}
@@ -183,47 +292,365 @@ namespace ecs
 		return managed<Component>() ? unsafeCollection<Component>().size() : 0U;
 	}
 
+	template <typename Component, typename... Components>
+	inline const ComponentGroup& EntityManager::group() {
+		static_assert(sizeof...(Components) > 0U, "Groups must own at least two components");
+
+		auto& collection = safeCollection<Component>();
+
+		if (auto owner = collection.owner()) {
+			if (!owner->owns(collection, safeCollection<Components>()...)) throw "Component already owned by another group";
+			return *owner;
+		}
+
+		auto owned = std::vector<Collection*>({ &collection, &safeCollection<Components>()... });
+		groups.push_back(std::make_unique<ComponentGroup>(owned));
+
+		return *groups.back();
+	}
+
+	template <typename... Components>
+	inline void EntityManager::prepare() {
+		auto preparing = { 0U, (safeCollection<Components>(), 0U)... };
+	}
+
+	template <typename Component>
+	inline ComponentCollection<Component>& EntityManager::collection() {
+		return safeCollection<Component>();
+	}
+
+	template <typename Component, typename Compare>
+	inline void EntityManager::sort(Compare compare, Collection::Sorting sorting) {
+		safeCollection<Component>().sort(compare, sorting);
+	}
+
+	template <typename Component, typename Other>
+	inline void EntityManager::respect() {
+		safeCollection<Component>().respect(safeCollection<Other>());
+	}
+
+	inline CommandBuffer& EntityManager::commands() {
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		auto& buffer = buffers[std::this_thread::get_id()];
+
+		if (!buffer) {
+			buffer = std::make_unique<CommandBuffer>();
+		}
+
+		return *buffer;
+	}
+
+	inline void EntityManager::flush() {
+		auto pending = std::vector<CommandBuffer*>();
+
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex);
+
+			for (auto& pair : buffers) {
+				pending.push_back(pair.second.get());
+			}
+		}
+
+		for (auto buffer : pending) {
+			buffer->playback(*this);
+		}
+
+		// Handlers may create collections, hence no iterators
+		for (auto uid = 0U; uid < collections.size(); ++uid) {
+			if (collections[uid]) {
+				collections[uid]->notify();
+			}
+		}
+	}
+
+	inline void EntityManager::snapshot(std::ostream& stream) {
+		auto count = unsigned(std::count_if(collections.begin(), collections.end(), [](const auto& collection) { return bool(collection); }));
+
+		Binary::write(stream, SNAPSHOT_MAGIC);
+		Binary::write(stream, SNAPSHOT_VERSION);
+		Binary::write(stream, SNAPSHOT_LAYOUT);
+		Binary::write(stream, clock->load());
+		Binary::write(stream, next);
+		Binary::write(stream, available);
+		Binary::write(stream, entities);
+		Binary::write(stream, count);
+
+		for (auto uid = 0U; uid < collections.size(); ++uid) {
+			if (collections[uid]) {
+				Binary::write(stream, uid);
+				collections[uid]->serialize(stream);
+			}
+		}
+	}
+
+	inline void EntityManager::restore(std::istream& stream) {
+		if (Binary::read<unsigned>(stream) != SNAPSHOT_MAGIC) throw "Not a world snapshot";
+		if (Binary::read<unsigned>(stream) != SNAPSHOT_VERSION) throw "Unsupported snapshot version";
+		if (Binary::read<unsigned>(stream) != SNAPSHOT_LAYOUT) throw "Snapshot entity layout mismatch";
+
+		// The whole snapshot is read into staging buffers first, so that a failure leaves the world untouched
+		auto tick = Binary::read<unsigned>(stream);
+		auto head = Binary::read<EntityId>(stream);
+		auto released = Binary::read<unsigned>(stream);
+		auto restored = std::pmr::vector<EntityId>(resource);
+		auto staged = std::vector<std::unique_ptr<Collection>>(collections.size());
+
+		Binary::read(stream, restored);
+
+		for (auto count = Binary::read<unsigned>(stream); count > 0U; --count) {
+			auto uid = Binary::read<unsigned>(stream);
+
+			if (uid >= collections.size() || !collections[uid]) throw "Unknown component in snapshot";
+			if (staged[uid]) throw "Corrupted snapshot";
+
+			staged[uid] = collections[uid]->stage();
+			staged[uid]->deserialize(stream);
+
+			for (auto index = 0U; index < staged[uid]->size(); ++index) {
+				if ((staged[uid]->data()[index] & Entity::ID_MASK) >= restored.size()) throw "Corrupted snapshot";
+			}
+		}
+
+		// Commands and batched notifications refer to entities of the replaced world
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex);
+
+			for (auto& buffer : buffers) {
+				buffer.second->clear();
+			}
+		}
+
+		for (auto& collection : collections) {
+			if (collection) {
+				collection->forget();
+				collection->discard(); // Components missing from the snapshot
+			}
+		}
+
+		clock->store(tick);
+		next = head;
+		available = released;
+		entities.swap(restored);
+		signatures->assign(entities.size(), Signature()); // Filled in by the collections
+
+		for (auto uid = 0U; uid < staged.size(); ++uid) {
+			if (staged[uid]) {
+				collections[uid]->adopt(*staged[uid]);
+			}
+		}
+	}
+
+	inline void EntityManager::load(const std::string& path) {
+		auto file = MappedSnapshot(path);
+
+		restore(file.read());
+		messages->publish<WorldLoaded>(size());
+	}
+
 	inline unsigned EntityManager::size() const {
 		return entities.size() - available;
 	}
 
-	inline unsigned EntityManager::version(unsigned entityId) const {
-		return unsigned((entityId >> Entity::VERSION_SHIFT) & Entity::VERSION_MASK);
+	inline ths::ThreadPool& EntityManager::workers() const {
+		return *pool;
+	}
+
+	inline std::pmr::memory_resource* EntityManager::memory() const {
+		return resource;
+	}
+
+	inline unsigned EntityManager::tick() const {
+		return clock->load(std::memory_order_relaxed);
+	}
+
+	inline unsigned EntityManager::advance() {
+		return clock->fetch_add(1U, std::memory_order_relaxed) + 1U;
+	}
+
+	inline unsigned EntityManager::observe(unsigned since) {
+		auto previous = observed();
+		observed() = since;
+		return previous;
+	}
+
+	inline EntityId EntityManager::version(EntityId entityId) const {
+		return EntityId((entityId >> Entity::VERSION_SHIFT) & Entity::VERSION_MASK);
 	}
 
-	inline unsigned EntityManager::current(unsigned entityId) const {
+	inline EntityId EntityManager::current(EntityId entityId) const {
 		auto index = entityId & Entity::ID_MASK;
 		assert(index < entities.size());
-		return unsigned((entities[index] >> Entity::VERSION_SHIFT) & Entity::VERSION_MASK);
+		return EntityId((entities[index] >> Entity::VERSION_SHIFT) & Entity::VERSION_MASK);
 	}
 
-	inline bool EntityManager::valid(unsigned entityId) const {
+	inline bool EntityManager::valid(EntityId entityId) const {
 		auto index = entityId & Entity::ID_MASK;
 		return index < entities.size() && entities[index] == entityId;
 	}
 
-	inline void EntityManager::destroy(unsigned entityId) {
+	inline void EntityManager::destroy(EntityId entityId) {
 		validate(entityId);
 
 		auto entity = entityId & Entity::ID_MASK;
-		auto version = (entityId & (~Entity::ID_MASK)) + (1U << Entity::VERSION_SHIFT);
+		auto version = (entityId & (~Entity::ID_MASK)) + (EntityId(1U) << Entity::VERSION_SHIFT);
 		auto node = (available ? next : ((entity + 1U) & Entity::ID_MASK)) | version;
 
 		entities[entity] = node;
 		next = entity;
 		available++;
 
-		for (auto& collection : collections) {
-			if (collection && collection->contains(entityId)) {
-				collection->remove(entityId);
+		// Only visits the collections the entity is in (removals update the signature, hence the copy)
+		visit(Signature((*signatures)[entity]), [this, entityId](unsigned uid) {
+			collections[uid]->remove(entityId);
+		});
+
+		untracked([this, entityId](unsigned uid) {
+			collections[uid]->remove(entityId);
+		});
+
+		messages->publish<EntityRemoved>(entityId);
+	}
+
+	template <typename Component, typename... Components>
+	inline void EntityManager::destroyAll() {
+		auto destroyed = std::vector<EntityId>();
+		auto counts = std::vector<unsigned>(collections.size());
+
+		// Invalidate the entities first, counting their components per collection
+		each<Component, Components...>([&](Entity& entity, auto&&...) {
+			visit((*signatures)[entity.id() & Entity::ID_MASK], [&counts](unsigned uid) {
+				counts[uid]++;
+			});
+
+			untracked([this, &counts, &entity](unsigned uid) {
+				counts[uid] += collections[uid]->contains(entity.id()) ? 1U : 0U;
+			});
+
+			destroyed.push_back(entity.id());
+		});
+
+		for (auto entityId : destroyed) {
+			auto index = entityId & Entity::ID_MASK;
+			entities[index] = (index + 1U) | ((entityId & ~Entity::ID_MASK) + (EntityId(1U) << Entity::VERSION_SHIFT));
+		}
+
+		// Collections holding destroyed entities only are cleared at once, the others one removal at a time
+		for (auto uid = 0U; uid < counts.size(); ++uid) {
+			if (counts[uid] && counts[uid] == collections[uid]->size()) {
+				collections[uid]->clear();
+				counts[uid] = 0U;
 			}
 		}
 
-		messages->publish<EntityRemoved>(entityId);
+		for (auto entityId : destroyed) {
+			visit(Signature((*signatures)[entityId & Entity::ID_MASK]), [this, entityId](unsigned uid) {
+				collections[uid]->remove(entityId);
+			});
+
+			untracked([this, &counts, entityId](unsigned uid) {
+				if (counts[uid]) collections[uid]->remove(entityId);
+			});
+		}
+
+		relink();
+
+		if (!destroyed.empty()) {
+			messages->publish<EntitiesRemoved>(destroyed);
+		}
+	}
+
+	inline void EntityManager::clear() {
+		auto destroyed = std::vector<EntityId>();
+
+		// Live entities hold their own index, released slots the next available one
+		if (messages->listened<EntitiesRemoved>()) {
+			for (auto index = 0U; index < entities.size(); ++index) {
+				if ((entities[index] & Entity::ID_MASK) == index) {
+					destroyed.push_back(entities[index]);
+				}
+			}
+		}
+
+		// Bits are dropped all at once below, rather than collection by collection
+		for (auto uid = 0U; uid < collections.size(); ++uid) {
+			if (collections[uid]) {
+				collections[uid]->track(nullptr, uid);
+				collections[uid]->clear();
+				collections[uid]->track(uid < Signature().size() ? signatures : nullptr, uid);
+			}
+		}
+
+		// Bump the version of every live entity, so that its handles become invalid
+		for (auto index = 0U; index < entities.size(); ++index) {
+			if ((entities[index] & Entity::ID_MASK) == index) {
+				entities[index] = (index + 1U) | ((entities[index] & ~Entity::ID_MASK) + (EntityId(1U) << Entity::VERSION_SHIFT));
+			}
+		}
+
+		signatures->assign(entities.size(), Signature());
+		relink();
+
+		if (!destroyed.empty()) {
+			messages->publish<EntitiesRemoved>(destroyed);
+		}
+	}
+
+	template <typename Function>
+	inline void EntityManager::visit(const Signature& signature, Function&& function) {
+		// Walks the signature 64 bits at a time
+		for (auto first = 0U; first < signature.size(); first += 64U) {
+			auto word = ((signature >> first) & Signature(~0ULL)).to_ullong();
+
+			for (auto uid = first; word; ++uid, word >>= 1U) {
+				if (word & 1U) {
+					function(uid);
+				}
+			}
+		}
+	}
+
+	template <typename Function>
+	inline void EntityManager::untracked(Function&& function) {
+		for (auto uid = unsigned(Signature().size()); uid < collections.size(); ++uid) {
+			if (collections[uid]) {
+				function(uid);
+			}
+		}
+	}
+
+	inline void EntityManager::relink() {
+		auto last = 0U;
+
+		next = 0U;
+		available = 0U;
+
+		// Free slots link to the next free one, in index order (live entities store their own index)
+		for (auto index = 0U; index < entities.size(); ++index) {
+			if ((entities[index] & Entity::ID_MASK) != index) {
+				if (available) {
+					entities[last] = index | (entities[last] & ~Entity::ID_MASK);
+				}
+				else {
+					next = index;
+				}
+
+				last = index;
+				available++;
+			}
+		}
 	}
 
 	template <typename Component>
 	inline ComponentCollection<Component>& EntityManager::safeCollection() {
+		if constexpr (!ComponentFamily::registered<Component>()) {
+			allocate<Component>(); // Registered ones are allocated on construction
+		}
+
+		return unsafeCollection<Component>();
+	}
+
+	template <typename Component>
+	inline void EntityManager::allocate() {
 		auto uid = ComponentFamily::uid<Component>();
 
 		if (uid >= collections.size()) {
@@ -231,10 +658,13 @@ namespace ecs
 		}
 
 		if (!collections[uid]) {
-			collections[uid] = std::make_unique<ComponentCollection<Component>>(messages);
-		}
+			collections[uid] = std::make_unique<ComponentCollection<Component>>(messages, resource);
+			collections[uid]->synchronize(clock);
 
-		return unsafeCollection<Component>();
+			if (uid < Signature().size()) {
+				collections[uid]->track(signatures, uid); // Those beyond are probed instead (see 'untracked')
+			}
+		}
 	}
 
 	template <typename Component>
@@ -246,12 +676,104 @@ namespace ecs
 	template <typename Component>
 	inline bool EntityManager::managed() const {
 		auto uid = ComponentFamily::uid<Component>();
-		return uid < collections.size() && collections[uid];
+		return ComponentFamily::registered<Component>() || (uid < collections.size() && collections[uid]);
 	}
 
-	template <bool>
-	inline bool EntityManager::has(unsigned entityId) {
-		return true; // Fallback function for recursion
+	template <typename... Components>
+	inline const Signature& EntityManager::signature() {
+		static const auto mask = []() {
+			auto uids = { ComponentFamily::uid<Components>()... };
+			auto bits = Signature();
+
+			for (auto uid : uids) {
+				if (uid >= bits.size()) return Signature(); // Never managed (see 'allocate')
+				bits.set(uid);
+			}
+
+			return bits;
+		}();
+
+		return mask;
+	}
+
+	template <typename... Components>
+	inline void EntityManager::preallocate(TypeList<Components...>) {
+		auto allocating = { 0U, (allocate<Components>(), 0U)... };
+	}
+
+	template <typename Context>
+	inline Context& EntityManager::context() {
+		if constexpr (!ContextFamily::registered<Context>()) {
+			allocateContext<Context>(); // Registered ones are allocated on construction
+		}
+
+		return *static_cast<Context*>(contexts[ContextFamily::uid<Context>()].get());
+	}
+
+	template <typename Context>
+	inline void EntityManager::allocateContext() {
+		auto uid = ContextFamily::uid<Context>();
+
+		if (uid >= contexts.size()) {
+			contexts.resize(uid + 1U);
+		}
+
+		if (!contexts[uid]) {
+			contexts[uid] = std::allocate_shared<Context>(std::pmr::polymorphic_allocator<Context>(resource));
+		}
+	}
+
+	template <typename... Components>
+	inline Signature EntityManager::exclusion() {
+		if ((... || signature<Components>().none())) throw "Excluded components must be within the signatures";
+
+		return (Signature() | ... | signature<Components>());
+	}
+
+	template <typename... Contexts>
+	inline void EntityManager::preallocateContexts(TypeList<Contexts...>) {
+		auto allocating = { 0U, (allocateContext<Contexts>(), 0U)... };
+	}
+
+	template <typename... Queries, typename Lambda>
+	inline void EntityManager::filter(Lambda& lambda, ths::ThreadPool* workers, unsigned chunk, const Signature& excluded) {
+		using Driver = std::tuple_element_t<firstFilter<Queries...>(), std::tuple<Queries...>>;
+
+		auto since = observed(); // Read on the calling thread, as parallel visits run on the workers
+		auto collections = std::tie(safeCollection<FilteredComponent<Queries>>()...);
+		auto& driver = std::get<ComponentCollection<FilteredComponent<Driver>>&>(collections);
+		auto excluding = excluded.any();
+
+		// Ticks are compared linearly, entities are only looked up in the other collections on a match
+		auto visit = [&](unsigned begin, unsigned end) {
+			for (auto index = begin; index < end; ++index) {
+				if (ComponentFilter<Driver>::admits(driver, index, since)) {
+					auto item = driver.data()[index];
+
+					if (excluding && ((*signatures)[item & Entity::ID_MASK] & excluded).any()) continue;
+
+					auto matching = (... && (std::get<ComponentCollection<FilteredComponent<Queries>>&>(collections).contains(item)
+						&& ComponentFilter<Queries>::accepts(std::get<ComponentCollection<FilteredComponent<Queries>>&>(collections), item, since)));
+
+					if (matching) {
+						auto entity = Entity(item, this);
+						lambda(entity, std::get<ComponentCollection<FilteredComponent<Queries>>&>(collections).get(item)...);
+					}
+				}
+			}
+		};
+
+		if (workers) {
+			workers->chunked(driver.size(), chunk, visit);
+		}
+		else {
+			visit(0U, driver.size());
+		}
+	}
+
+	inline unsigned& EntityManager::observed() {
+		static thread_local unsigned since = 0U; // Everything is reported outside of systems, unless observing
+		return since;
 	}
 
 	template <bool>
@@ -265,28 +787,68 @@ namespace ecs
 	}
 
 	template <bool>
-	inline void EntityManager::remove(unsigned entityId) {
+	inline void EntityManager::remove(EntityId entityId) {
 		// Fallback blank function for recursion
 	}
 
 	template <bool>
-	inline void EntityManager::reset(unsigned entityId) {
+	inline void EntityManager::reset(EntityId entityId) {
 		// Fallback blank function for recursion
 	}
 
-	inline void EntityManager::assign(unsigned entityId) {
+	inline void EntityManager::assign(EntityId entityId) {
 		// Fallback blank function for recursion
 	}
 
-	inline void EntityManager::replace(unsigned entityId) {
+	inline void EntityManager::replace(EntityId entityId) {
 		// Fallback blank function for recursion
 	}
 
-	inline void EntityManager::save(unsigned entityId) {
+	template <typename Component, typename... Components>
+	inline void EntityManager::assign(const std::vector<EntityId>& entityIds, const Component& component, const Components&... components) {
+		safeCollection<Component>().add(entityIds, component);
+		assign(entityIds, components...);
+	}
+
+	inline void EntityManager::assign(const std::vector<EntityId>& entityIds) {
 		// Fallback blank function for recursion
 	}
 
-	inline void EntityManager::validate(unsigned entityId) {
+	inline EntityId EntityManager::generate() {
+		EntityId id = 0U;
+
+		if (available) {
+			auto entity = next;
+			auto version = entities[entity] & ~Entity::ID_MASK;
+
+			id = entity | version;
+			next = entities[entity] & Entity::ID_MASK;
+			entities[entity] = id;
+			available--;
+		}
+		else {
+			id = entities.size();
+			assert(id < Entity::ID_MASK);
+			entities.push_back(id);
+			signatures->emplace_back();
+		}
+
+		return id;
+	}
+
+	inline void EntityManager::save(EntityId entityId) {
+		// Fallback blank function for recursion
+	}
+
+	inline EntityId EntityManager::identifier(EntityId entityId) {
+		return entityId;
+	}
+
+	inline EntityId EntityManager::identifier(const Entity& entity) {
+		return entity.id();
+	}
+
+	inline void EntityManager::validate(EntityId entityId) {
 		if (!valid(entityId)) throw "Invalid entity identifier";
 	}
 }
@@ -0,0 +1,51 @@
+#ifndef ECS_ENTITY_TRAITS_IMPL
+#define ECS_ENTITY_TRAITS_IMPL
+
+#include <cstdint>
+
+namespace ecs
+{
+	/**
+	* @brief Layout of entity identifiers.
+	*
+	* The low bits of an identifier index the entity, the high bits hold its version,
+	* bumped whenever the index is recycled so that stale handles can be told apart. The
+	* sparse sets of the collections flag their occupied slots with the bit right above
+	* the index bits.
+	*
+	* @tparam Type Unsigned integer type of the identifiers.
+	* @tparam IndexBits Amount of bits of the index, the remaining ones holding the version.
+	*/
+	template <typename Type, unsigned IndexBits>
+	struct EntityLayout
+	{
+		static_assert(IndexBits < sizeof(Type) * 8U, "Entity identifiers need room for a version");
+
+		using Id = Type;
+
+		static constexpr Type ID_MASK = (Type(1U) << IndexBits) - 1U;
+		static constexpr Type VERSION_MASK = Type(~Type(0U)) >> IndexBits;
+		static constexpr unsigned VERSION_SHIFT = IndexBits;
+		static constexpr Type OCCUPIED = Type(1U) << IndexBits;
+	};
+
+	using EntityLayout32 = EntityLayout<std::uint32_t, 24U>; // 16M entities, 256 versions each
+	using EntityLayout64 = EntityLayout<std::uint64_t, 32U>; // 4G entities, 4G versions each
+
+	/**
+	* @brief Layout of the entity identifiers of the engine.
+	*
+	* Specialize it to widen the identifiers. As with `Registry`, the specialization must be
+	* visible before any other engine header, in every translation unit:
+	*
+	* @code
+	* #include "Engine/Entities/Entity/EntityTraits.hpp"
+	*
+	* template <> struct ecs::EntityTraits<> : ecs::EntityLayout64 {};
+	* @endcode
+	*/
+	template <typename = void>
+	struct EntityTraits : EntityLayout32 {};
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef ECS_MAPPED_SNAPSHOT_IMPL
+#define ECS_MAPPED_SNAPSHOT_IMPL
+
+#include <memory>
+#include <string>
+#include <istream>
+
+#include "../Component/ComponentSerialization.hpp"
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace ecs
+{
+	/**
+	* @brief Copy-on-write memory mapping of a snapshot file.
+	*
+	* The snapshot is streamed straight from the mapping rather than through a file buffer.
+	* Components stored in a `MappedStorage` are adopted in place, keeping the mapping alive
+	* until they are moved elsewhere, while the other storages copy theirs out of the pages
+	* (see `EntityManager::load`). Writes to adopted components stay private to the process.
+	*/
+	class MappedSnapshot final
+	{
+	public:
+		explicit MappedSnapshot(const std::string& path) : stream(&buffer) {
+			auto mapping = std::make_shared<Mapping>();
+#ifdef _WIN32
+			auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE) throw "Cannot open snapshot file";
+
+			LARGE_INTEGER length;
+			if (!GetFileSizeEx(file, &length)) { CloseHandle(file); throw "Cannot read snapshot file size"; }
+			mapping->size = std::size_t(length.QuadPart);
+
+			if (mapping->size) {
+				auto handle = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+				mapping->data = handle ? static_cast<char*>(MapViewOfFile(handle, FILE_MAP_COPY, 0, 0, 0)) : nullptr;
+				if (handle) CloseHandle(handle); // The view keeps the mapping open
+			}
+
+			CloseHandle(file);
+#else
+			auto file = open(path.c_str(), O_RDONLY);
+			if (file < 0) throw "Cannot open snapshot file";
+
+			struct stat status;
+			if (fstat(file, &status) != 0) { close(file); throw "Cannot read snapshot file size"; }
+			mapping->size = std::size_t(status.st_size);
+
+			if (mapping->size) {
+				auto view = mmap(nullptr, mapping->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+
+				if (view != MAP_FAILED) {
+					mapping->data = static_cast<char*>(view);
+					madvise(view, mapping->size, MADV_SEQUENTIAL);
+				}
+			}
+
+			close(file); // The mapping keeps the file open
+#endif
+			if (mapping->size && !mapping->data) throw "Cannot map snapshot file";
+
+			buffer.expose(mapping->data, mapping->size, mapping);
+		}
+
+		MappedSnapshot(const MappedSnapshot&) = delete;
+		MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+		std::istream& read() {
+			return stream;
+		}
+
+	private:
+		// Mapped view of the file, released once neither the snapshot nor any storage uses it
+		struct Mapping final
+		{
+			~Mapping() {
+				if (data) {
+#ifdef _WIN32
+					UnmapViewOfFile(data);
+#else
+					munmap(data, size);
+#endif
+				}
+			}
+
+			char* data = nullptr;
+			std::size_t size = 0U;
+		};
+
+		// Get area spanning the whole mapping, no copy involved
+		struct Buffer final : public MappedBuffer
+		{
+			using MappedBuffer::expose;
+		};
+
+	private:
+		Buffer buffer;
+		std::istream stream;
+	};
+}
+
+#endif
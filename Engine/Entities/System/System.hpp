@@ -1,23 +1,163 @@
 #ifndef ECS_SYSTEM_IMPL
 #define ECS_SYSTEM_IMPL
 
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
+
+#include "WorldTraits.hpp"
 #include "../Entity/EntityManager.hpp"
+#include "../Archetype/ArchetypeManager.hpp"
 #include "../../Messages/MessageManager.hpp"
 
 namespace ecs
 {
+	using World = WorldTraits<>::type; // Fixes the backend, hence no specialization past this point
+
+	/**
+	* @brief Components, contexts and messages a system reads and writes while updating.
+	*
+	* Systems declaring their access may run concurrently with the systems they do not
+	* conflict with, on the worker threads. Those which do not declare anything, or declare
+	* structural changes (creating or destroying entities, adding, replacing or removing
+	* components) are run exclusively, on the thread updating the systems. Concurrent
+	* systems must record their structural changes in `EntityManager::commands` instead,
+	* which archetype worlds don't provide.
+	*/
+	class SystemAccess final
+	{
+	public:
+		template <typename... Components>
+		SystemAccess& reads() {
+			declare(componentReads, { ComponentFamily::uid<Components>()... });
+			return prepare<Components...>();
+		}
+
+		template <typename... Components>
+		SystemAccess& writes() {
+			declare(componentWrites, { ComponentFamily::uid<Components>()... });
+			return prepare<Components...>();
+		}
+
+		// World-wide singletons (see EntityManager::context), which are created upfront
+		template <typename... Contexts>
+		SystemAccess& readsContext() {
+			declare(contextReads, { ContextFamily::uid<Contexts>()... });
+			return provide<Contexts...>();
+		}
+
+		template <typename... Contexts>
+		SystemAccess& writesContext() {
+			declare(contextWrites, { ContextFamily::uid<Contexts>()... });
+			return provide<Contexts...>();
+		}
+
+		// Messages handled by the system (its handlers run in the thread of the publisher)
+		template <typename... Messages>
+		SystemAccess& receives() {
+			return declare(messageReads, { MessageFamily::uid<Messages>()... });
+		}
+
+		template <typename... Messages>
+		SystemAccess& publishes() {
+			return declare(messageWrites, { MessageFamily::uid<Messages>()... });
+		}
+
+		// Changes made directly through the entity manager, which touch state shared by every entity
+		SystemAccess& structural() {
+			structure = true;
+			declaration = true;
+			return *this;
+		}
+
+		// Creates the collections of the declared components, so they are not lazily created concurrently
+		void prepare(ecs::World& entities) const {
+			for (auto preparer : preparers) {
+				preparer(entities);
+			}
+		}
+
+		bool declared() const {
+			return declaration;
+		}
+
+		// Whether the system must run alone, on the thread updating the systems
+		bool exclusive() const {
+			return !declaration || structure;
+		}
+
+		bool conflicts(const SystemAccess& other) const {
+			if (exclusive() || other.exclusive()) {
+				return true;
+			}
+
+			auto publishing = !messageWrites.empty() && !other.messageWrites.empty(); // The message manager is not thread safe
+
+			return publishing
+				|| intersects(componentWrites, other.componentWrites)
+				|| intersects(componentWrites, other.componentReads)
+				|| intersects(componentReads, other.componentWrites)
+				|| intersects(contextWrites, other.contextWrites)
+				|| intersects(contextWrites, other.contextReads)
+				|| intersects(contextReads, other.contextWrites)
+				|| intersects(messageWrites, other.messageReads)
+				|| intersects(messageReads, other.messageWrites);
+		}
+
+	private:
+		SystemAccess& declare(std::vector<unsigned>& uids, std::initializer_list<unsigned> declared) {
+			uids.insert(uids.end(), declared);
+			declaration = true;
+			return *this;
+		}
+
+		template <typename... Components>
+		SystemAccess& prepare() {
+			preparers.push_back([](ecs::World& entities) { entities.prepare<Components...>(); });
+			return *this;
+		}
+
+		template <typename... Contexts>
+		SystemAccess& provide() {
+			preparers.push_back([](ecs::World& entities) { auto providing = { 0U, (entities.context<Contexts>(), 0U)... }; });
+			return *this;
+		}
+
+		static bool intersects(const std::vector<unsigned>& left, const std::vector<unsigned>& right) {
+			return std::find_first_of(left.begin(), left.end(), right.begin(), right.end()) != left.end();
+		}
+
+	private:
+		bool declaration = false;
+		bool structure = false;
+		std::vector<unsigned> componentReads;
+		std::vector<unsigned> componentWrites;
+		std::vector<unsigned> contextReads;
+		std::vector<unsigned> contextWrites;
+		std::vector<unsigned> messageReads;
+		std::vector<unsigned> messageWrites;
+		std::vector<void(*)(ecs::World&)> preparers;
+	};
+
 	class System
 	{
 	public:
+		virtual ~System() = default;
 		virtual void update(float delta) = 0;
-		virtual void configure(const std::shared_ptr<ecs::EntityManager>& entities, const std::shared_ptr<mqs::MessageManager>& messages) {
+
+		// Resources used by the update, which enable it to run concurrently (nothing is declared by default)
+		virtual SystemAccess access() const {
+			return SystemAccess();
+		}
+
+		virtual void configure(const std::shared_ptr<ecs::World>& entities, const std::shared_ptr<mqs::MessageManager>& messages) {
 			this->messages = messages;
 			this->entities = entities;
 		}
 
 	protected:
 		std::shared_ptr<mqs::MessageManager> messages;
-		std::shared_ptr<ecs::EntityManager> entities;
+		std::shared_ptr<ecs::World> entities;
 	};
 
 	// Definition
@@ -35,7 +175,7 @@ namespace ecs
 			}
 		}
 
-		void configure(const std::shared_ptr<ecs::EntityManager>& entities, const std::shared_ptr<mqs::MessageManager>& messages) override {
+		void configure(const std::shared_ptr<ecs::World>& entities, const std::shared_ptr<mqs::MessageManager>& messages) override {
 			System::configure(entities, messages);
 			connections.push_back(messages->on<T>(this));
 		}
@@ -55,7 +195,7 @@ namespace ecs
 			}
 		}
 
-		void configure(const std::shared_ptr<ecs::EntityManager>& entities, const std::shared_ptr<mqs::MessageManager>& messages) override {
+		void configure(const std::shared_ptr<ecs::World>& entities, const std::shared_ptr<mqs::MessageManager>& messages) override {
 			System::configure(entities, messages);
 			connections.push_back(messages->on<T>(this));
 			connections.push_back(messages->on<Tn...>(this));
@@ -1,14 +1,42 @@
 #ifndef ECS_SYSTEM_MANAGER_IMPL
 #define ECS_SYSTEM_MANAGER_IMPL
 
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <typeinfo>
+#include <algorithm>
+#include <exception>
+
 #include "System.hpp"
 
 namespace ecs
 {
+	/**
+	* @brief Timings of the last scheduled frame.
+	*
+	* The critical path is the longest chain of dependent systems, hence the lower bound
+	* of the frame time no matter how many threads are available.
+	*/
+	struct SystemReport final
+	{
+		struct Entry final
+		{
+			const char* name; // System type name
+			float duration; // Seconds spent updating
+		};
+
+		float frame = 0.f; // Seconds spent running all the systems
+		float critical = 0.f; // Seconds spent along the critical path
+		std::vector<Entry> systems; // Every system, in registration order
+		std::vector<Entry> path; // Systems along the critical path, in execution order
+	};
+
 	class SystemManager final
 	{
 	public:
-		SystemManager(const std::shared_ptr<ecs::EntityManager>& entities, const std::shared_ptr<mqs::MessageManager>& messages)
+		SystemManager(const std::shared_ptr<ecs::World>& entities, const std::shared_ptr<mqs::MessageManager>& messages)
 			: entities(entities)
 			, messages(messages)
 		{}
@@ -16,21 +44,205 @@ namespace ecs
 		template <typename S, typename = typename std::enable_if<std::is_base_of<ecs::System, S>::value>::type, typename... Args>
 		void add(Args&&... systemArgs) {
 			auto system = new S(std::forward<Args>(systemArgs)...);
+			auto access = system->access();
+			auto index = systems.size();
+
 			system->configure(entities, messages);
+			access.prepare(*entities);
 			systems.emplace_back(system);
+			names.push_back(typeid(S).name());
+			dependencies.emplace_back();
+			dependents.emplace_back();
+			ticks.push_back(0U);
+
+			// Systems conflicting with an earlier one keep running after it, as in registration order
+			for (auto other = 0U; other < index; ++other) {
+				if (access.conflicts(accesses[other])) {
+					dependencies[index].push_back(other);
+					dependents[other].push_back(index);
+				}
+			}
+
+			accesses.push_back(std::move(access));
 		}
 
+		/**
+		* @brief Updates every system.
+		*
+		* Systems are arranged in a dependency graph: a system depends on every earlier
+		* registered system it conflicts with (see `SystemAccess`). Those whose dependencies
+		* are done are run concurrently on the worker threads of the entity manager, except
+		* exclusive systems which run alone on the calling thread (e.g. those drawing to a
+		* window). Commands recorded by the systems (see `EntityManager::commands`) are
+		* played back once all of them are done.
+		*
+		* Every system starts a new tick of the world clock and observes the changes made
+		* since its previous start (see `Changed` and `Added` filters).
+		*/
 		void update(float delta) {
-			for (auto& system : systems) {
-				system->update(delta);
+			auto& pool = entities->workers();
+			auto count = unsigned(systems.size());
+			auto start = Clock::now();
+
+			durations.assign(count, 0.f);
+
+			if (pool.concurrency() == 1U) {
+				for (auto index = 0U; index < count; ++index) {
+					run(index, delta);
+				}
+			}
+			else {
+				schedule(pool, delta);
+			}
+
+			entities->advance(); // Played back changes are newer than every system start
+			entities->flush(); // Sync point: structural changes recorded by the systems are applied
+
+			analyze(std::chrono::duration<float>(Clock::now() - start).count());
+		}
+
+		// Timings of the last frame
+		const SystemReport& report() const {
+			return statistics;
+		}
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Frame final
+		{
+			explicit Frame(unsigned count) : pending(new std::atomic<unsigned>[count]) {}
+
+			std::atomic<unsigned> done { 0U };
+			std::unique_ptr<std::atomic<unsigned>[]> pending; // Unfinished dependencies of each system
+			std::exception_ptr error;
+			std::mutex mutex;
+		};
+
+		void run(unsigned index, float delta) {
+			auto start = Clock::now();
+			auto previous = entities->observe(ticks[index]);
+
+			ticks[index] = entities->advance();
+			systems[index]->update(delta);
+			entities->observe(previous);
+			durations[index] = std::chrono::duration<float>(Clock::now() - start).count();
+		}
+
+		// Runs the exclusive systems inline, and the declared ones between them as batches on the pool
+		void schedule(ths::ThreadPool& pool, float delta) {
+			auto count = unsigned(systems.size());
+			Frame frame(count);
+
+			for (auto first = 0U; first < count; ) {
+				if (accesses[first].exclusive()) {
+					run(first++, delta);
+					continue;
+				}
+
+				auto last = first;
+
+				while (last < count && !accesses[last].exclusive()) {
+					last++;
+				}
+
+				batch(pool, frame, first, last, delta);
+				first = last;
+			}
+		}
+
+		// Runs the systems in [first, last) on the pool, earlier systems being done (none of them is exclusive)
+		void batch(ths::ThreadPool& pool, Frame& frame, unsigned first, unsigned last, float delta) {
+			frame.done = 0U;
+
+			for (auto index = first; index < last; ++index) {
+				frame.pending[index] = unsigned(std::count_if(dependencies[index].begin(), dependencies[index].end(), [first](unsigned dependency) {
+					return dependency >= first;
+				}));
+			}
+
+			for (auto index = first; index < last; ++index) {
+				if (frame.pending[index] == 0U) {
+					submit(pool, frame, index, last, delta);
+				}
+			}
+
+			while (frame.done < last - first) {
+				if (!pool.work()) {
+					std::this_thread::yield();
+				}
+			}
+
+			if (frame.error) {
+				std::rethrow_exception(frame.error);
+			}
+		}
+
+		void submit(ths::ThreadPool& pool, Frame& frame, unsigned index, unsigned last, float delta) {
+			pool.submit([this, &pool, &frame, index, last, delta]() {
+				try {
+					run(index, delta);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(frame.mutex);
+					frame.error = std::current_exception();
+				}
+
+				for (auto dependent : dependents[index]) {
+					if (dependent < last && --frame.pending[dependent] == 0U) {
+						submit(pool, frame, dependent, last, delta);
+					}
+				}
+
+				frame.done++;
+			});
+		}
+
+		void analyze(float elapsed) {
+			auto count = systems.size();
+			auto finishes = std::vector<float>(count, 0.f); // Longest path ending at each system
+			auto previous = std::vector<int>(count, -1);
+			auto last = -1;
+
+			statistics.frame = elapsed;
+			statistics.critical = 0.f;
+			statistics.systems.clear();
+			statistics.path.clear();
+
+			for (auto index = 0U; index < count; ++index) {
+				for (auto dependency : dependencies[index]) {
+					if (finishes[dependency] > finishes[index]) {
+						finishes[index] = finishes[dependency];
+						previous[index] = dependency;
+					}
+				}
+
+				finishes[index] += durations[index];
+				statistics.systems.push_back({ names[index], durations[index] });
+
+				if (finishes[index] >= statistics.critical) {
+					statistics.critical = finishes[index];
+					last = index;
+				}
+			}
+
+			for (auto index = last; index >= 0; index = previous[index]) {
+				statistics.path.insert(statistics.path.begin(), { names[index], durations[index] });
 			}
 		}
 
 	private:
 		std::shared_ptr<mqs::MessageManager> messages;
-		std::shared_ptr<ecs::EntityManager> entities;
+		std::shared_ptr<ecs::World> entities;
 		std::vector<std::shared_ptr<System>> systems;
+		std::vector<SystemAccess> accesses;
+		std::vector<std::vector<unsigned>> dependencies; // Earlier systems each system must wait for
+		std::vector<std::vector<unsigned>> dependents; // Later systems waiting for each system
+		std::vector<const char*> names;
+		std::vector<float> durations; // Seconds spent by each system in the last frame
+		std::vector<unsigned> ticks; // Tick at which each system last started
+		SystemReport statistics;
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,33 @@
+#ifndef ECS_WORLD_TRAITS_IMPL
+#define ECS_WORLD_TRAITS_IMPL
+
+namespace ecs
+{
+	class EntityManager;
+	class ArchetypeManager;
+
+	/**
+	* @brief Storage backend of the world the systems run on (see `World`).
+	*
+	* Entities are stored in sparse sets by default (`EntityManager`), or grouped by
+	* archetype (`ArchetypeManager`). Specialize it to switch backends. As with `Registry`,
+	* the specialization must be visible before any other engine header, in every
+	* translation unit:
+	*
+	* @code
+	* #include "Engine/Entities/System/WorldTraits.hpp"
+	*
+	* template <> struct ecs::WorldTraits<> { using type = ecs::ArchetypeManager; };
+	* @endcode
+	*
+	* Systems using sparse set specific features (collections, groups, sorting, command
+	* buffers, snapshots) only build against `EntityManager`.
+	*/
+	template <typename = void>
+	struct WorldTraits
+	{
+		using type = EntityManager;
+	};
+}
+
+#endif
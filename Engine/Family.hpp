@@ -1,8 +1,39 @@
 #ifndef UTILS_FAMILY_IMPL
 #define UTILS_FAMILY_IMPL
 
+#include <atomic>
 #include <type_traits>
 
+template <typename...>
+struct TypeList final
+{
+	static constexpr unsigned size = 0U;
+};
+
+template <typename Type, typename... Types>
+struct TypeList<Type, Types...> final
+{
+	static constexpr unsigned size = 1U + sizeof...(Types);
+};
+
+/**
+* @brief Types of a family whose identifiers are known at compile time.
+*
+* Registered types are identified by their position in the list, which is stable
+* across builds and usable in constant expressions (see `Family::id`). Identifiers
+* of the other types follow, assigned at runtime on first use. Specializations must
+* be visible before any engine header, in every translation unit:
+*
+* @code
+* template <> struct Registry<ComponentFamily> { using types = TypeList<Transform, Motion>; };
+* @endcode
+*/
+template <typename Family>
+struct Registry
+{
+	using types = TypeList<>;
+};
+
 /**
 * @brief Dynamic identifier generator.
 *
@@ -19,12 +50,45 @@ public:
 	*/
 	template <typename... T>
 	static unsigned uid() noexcept {
-		return generate<std::decay_t<T>...>(); // Remove L/R values
+		if constexpr (registered<T...>()) {
+			return id<T...>(); // Constant
+		}
+		else {
+			return generate<std::decay_t<T>...>(); // Remove L/R values
+		}
+	}
+
+	/**
+	* @brief Returns the compile-time identifier of a registered type.
+	* @return Position of the type within the registry of the family.
+	*/
+	template <typename T>
+	static constexpr unsigned id() noexcept {
+		static_assert(registered<T>(), "Type not registered for this family");
+		return position<std::decay_t<T>>(Types());
+	}
+
+	template <typename... T>
+	static constexpr bool registered() noexcept {
+		return sizeof...(T) == 1U && (... && (position<std::decay_t<T>>(Types()) < Types::size));
 	}
 
 private:
+	using Types = typename Registry<Family>::types;
+
+	template <typename T, typename... Registered>
+	static constexpr unsigned position(TypeList<Registered...>) noexcept {
+		constexpr bool matches[] = { false, std::is_same<T, Registered>::value... };
+
+		for (auto index = 1U; index <= sizeof...(Registered); ++index) {
+			if (matches[index]) return index - 1U;
+		}
+
+		return sizeof...(Registered);
+	}
+
 	static unsigned entity() noexcept {
-		static unsigned value = 0U;
+		static std::atomic<unsigned> value { Types::size }; // After the registered types, types may be first used concurrently
 		return value++;
 	}
 
@@ -37,5 +101,6 @@ private:
 
 using MessageFamily = Family<struct Messages>;
 using ComponentFamily = Family<struct Components>;
+using ContextFamily = Family<struct Contexts>;
 
-#endif
\ No newline at end of file
+#endif
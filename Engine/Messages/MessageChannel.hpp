@@ -19,11 +19,13 @@ namespace mqs
 			return signal.connect(function);
 		}
 
-		// Constructs a message in-place and immediately publish it
+		// Constructs a message in-place and immediately publish it (unless nobody would receive it)
 		template <typename Message, typename = typename std::enable_if<std::is_base_of<mqs::Message, Message>::value>::type, typename... Args>
 		void publish(const mqs::MessageHook& hook, Args&&... messageArgs) {
-			auto message = Message(std::forward<Args>(messageArgs)...);
-			publish(hook, message);
+			if (listened(hook)) {
+				auto message = Message(std::forward<Args>(messageArgs)...);
+				publish(hook, message);
+			}
 		}
 
 		// Immediatelly publishes a message
@@ -54,6 +56,11 @@ namespace mqs
 			return !messages.empty();
 		}
 
+		// Checks whether a published message would reach any handler or hook
+		bool listened(const mqs::MessageHook& hook) const {
+			return signal.connections() || hook.pre.connections() || hook.post.connections();
+		}
+
 	private:
 		mqs::Signal<void(const mqs::Message&)> signal;
 		std::queue<std::shared_ptr<mqs::Message>> messages;
@@ -1,6 +1,7 @@
 #ifndef MESSAGES_MESSAGE_MANAGER_IMPL
 #define MESSAGES_MESSAGE_MANAGER_IMPL
 
+#include <vector>
 #include <typeindex>
 #include <unordered_map>
 
@@ -25,7 +26,7 @@ namespace mqs
 		// Registers an even handler of the given message type
 		template <typename M>
 		SignalConnection on(const std::function<void(const mqs::Message&)>& function) {
-			return channels[typeid(M)].connect(function);
+			return channel<M>().connect(function);
 		}
 
 		// Registers an even handler of the given message type
@@ -33,7 +34,7 @@ namespace mqs
 		SignalConnection on(const mqs::MessageListener<M>* listener) {
 			auto constlessListener = const_cast<mqs::MessageListener<M>*>(listener);
 
-			return channels[typeid(M)].connect([constlessListener](const mqs::Message& message) {
+			return channel<M>().connect([constlessListener](const mqs::Message& message) {
 				constlessListener->handle(dynamic_cast<const M&>(message));
 			});
 		}
@@ -41,7 +42,7 @@ namespace mqs
 		// Constructs a message in-place and immediatelly publish it
 		template <typename M, typename = typename std::enable_if<std::is_base_of<mqs::Message, M>::value>::type, typename... Args>
 		void publish(Args&&... messageArgs) {
-			channels[typeid(M)].publish<M>(hooks, messageArgs...);
+			channel<M>().template publish<M>(hooks, messageArgs...);
 		}
 
 		// Immediatelly publishes a message
@@ -52,7 +53,7 @@ namespace mqs
 		// Publishes every queued messages of a given type
 		template <typename M, typename = typename std::enable_if<std::is_base_of<mqs::Message, M>::value>::type>
 		void flush() {
-			channels[typeid(M)].flush(hooks);
+			channel<M>().flush(hooks);
 		}
 
 		// Publishes every queued messages of all types
@@ -65,13 +66,26 @@ namespace mqs
 		// Constructs a message in-place and queue it
 		template <typename M, typename = typename std::enable_if<std::is_base_of<mqs::Message, M>::value>::type, typename... Args>
 		void push(Args&&... messageArgs) {
-			channels[typeid(M)].push<M>(messageArgs...);
+			channel<M>().template push<M>(messageArgs...);
 		}
 
 		// Checks whether there are pending messages of a given type to be published
 		template <typename M, typename = typename std::enable_if<std::is_base_of<mqs::Message, M>::value>::type>
 		bool pending() {
-			return channels[typeid(M)].pending();
+			return channel<M>().pending();
+		}
+
+		// Checks whether publishing a message of the given type would reach any handler or hook (creates no channel)
+		template <typename M, typename = typename std::enable_if<std::is_base_of<mqs::Message, M>::value>::type>
+		bool listened() const {
+			auto uid = MessageFamily::uid<M>();
+
+			if (uid < cache.size() && cache[uid]) {
+				return cache[uid]->listened(hooks);
+			}
+
+			auto found = channels.find(typeid(M));
+			return found != channels.end() ? found->second.listened(hooks) : hooks.pre.connections() || hooks.post.connections();
 		}
 
 		// Checks whether there are any pending messages to be published
@@ -85,9 +99,27 @@ namespace mqs
 			return pending;
 		}
 
+	private:
+		// Channel of the given message type, cached by family to spare hashing its type
+		template <typename M>
+		mqs::MessageChannel& channel() {
+			auto uid = MessageFamily::uid<M>();
+
+			if (uid >= cache.size()) {
+				cache.resize(uid + 1U, nullptr);
+			}
+
+			if (!cache[uid]) {
+				cache[uid] = &channels[typeid(M)]; // Map nodes are never moved
+			}
+
+			return *cache[uid];
+		}
+
 	private:
 		mqs::MessageHook hooks;
 		std::unordered_map<std::type_index, mqs::MessageChannel> channels;
+		std::vector<mqs::MessageChannel*> cache; // Indexed by message family
 	};
 }
 
@@ -0,0 +1,178 @@
+#ifndef THREADS_THREAD_POOL_IMPL
+#define THREADS_THREAD_POOL_IMPL
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+namespace ths
+{
+	/**
+	* @brief Fixed set of worker threads consuming a shared task queue.
+	*
+	* Threads waiting for tasks to finish (see `parallel`) keep executing queued tasks
+	* meanwhile, hence tasks may safely wait for nested tasks without starving the pool.
+	*/
+	class ThreadPool final
+	{
+	public:
+		explicit ThreadPool(unsigned workers = std::max(1U, std::thread::hardware_concurrency()) - 1U) {
+			for (auto index = 0U; index < workers; ++index) {
+				threads.emplace_back([this]() {
+					while (auto task = pop(true)) {
+						task();
+					}
+				});
+			}
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+
+			condition.notify_all();
+
+			for (auto& thread : threads) {
+				thread.join();
+			}
+		}
+
+		// Pool shared by the worlds which are not given one, so that several of them don't oversubscribe the cores
+		static const std::shared_ptr<ThreadPool>& shared() {
+			static auto pool = std::make_shared<ThreadPool>();
+			return pool;
+		}
+
+		// Amount of threads able to run tasks concurrently, including the calling one
+		unsigned concurrency() const {
+			return threads.size() + 1U;
+		}
+
+		// Queues a task to be executed by any of the workers
+		void submit(std::function<void()> task) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tasks.push_back(std::move(task));
+			}
+
+			condition.notify_one();
+		}
+
+		// Executes a single queued task in the calling thread, if there is any
+		bool work() {
+			auto task = pop(false);
+
+			if (task) {
+				task();
+			}
+
+			return static_cast<bool>(task);
+		}
+
+		// Invokes the task for every index in [0, count) across the workers and the calling thread, returning once all are done.
+		// Once the task throws, the remaining indices are skipped and the first exception is rethrown on the calling thread
+		template <typename Task>
+		void parallel(unsigned count, Task&& task) {
+			struct Progress {
+				std::atomic<unsigned> next { 0U };
+				std::atomic<unsigned> done { 0U };
+				std::atomic<bool> failed { false };
+				std::exception_ptr error;
+				std::mutex mutex;
+			};
+
+			auto progress = std::make_shared<Progress>(); // Outlives helpers which are dequeued after we return
+			auto function = &task;
+
+			auto help = [progress, function, count]() {
+				for (auto index = progress->next++; index < count; index = progress->next++) {
+					if (!progress->failed) {
+						try {
+							(*function)(index);
+						}
+						catch (...) {
+							std::lock_guard<std::mutex> lock(progress->mutex);
+
+							if (!progress->error) {
+								progress->error = std::current_exception();
+							}
+
+							progress->failed = true;
+						}
+					}
+
+					progress->done++;
+				}
+			};
+
+			auto helpers = std::min<unsigned>(threads.size(), count > 0U ? count - 1U : 0U);
+
+			for (auto index = 0U; index < helpers; ++index) {
+				submit(help);
+			}
+
+			help();
+
+			// The task must outlive every invocation, even when one of them threw
+			while (progress->done < count) {
+				if (!work()) {
+					std::this_thread::yield();
+				}
+			}
+
+			if (progress->error) {
+				std::rethrow_exception(progress->error);
+			}
+		}
+
+		// Splits [0, size) into chunks and invokes the task with the bounds of each one, in parallel
+		template <typename Task>
+		void chunked(unsigned size, unsigned chunk, Task&& task) {
+			chunk = chunk ? chunk : std::max(MIN_CHUNK, size / (concurrency() * 4U) + 1U); // Some slack for load balancing
+
+			parallel((size + chunk - 1U) / chunk, [&task, size, chunk](unsigned index) {
+				task(index * chunk, std::min(size, index * chunk + chunk));
+			});
+		}
+
+	private:
+		std::function<void()> pop(bool wait) {
+			std::unique_lock<std::mutex> lock(mutex);
+
+			if (wait) {
+				condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+			}
+
+			if (tasks.empty()) {
+				return nullptr;
+			}
+
+			auto task = std::move(tasks.front());
+			tasks.pop_front();
+
+			return task;
+		}
+
+	private:
+		static constexpr unsigned MIN_CHUNK = 1024U; // Smaller chunks are dominated by scheduling costs
+		bool stopping = false;
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<std::function<void()>> tasks;
+		std::vector<std::thread> threads;
+	};
+}
+
+#endif
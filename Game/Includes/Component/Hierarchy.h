@@ -0,0 +1,18 @@
+#pragma once
+
+#include <limits>
+#include <Engine/Entities/Entity/Entity.h>
+
+// Attaches the entity to a parent, its world transform following the parent's (see HierarchySystem)
+struct Hierarchy
+{
+	explicit Hierarchy(ecs::EntityId parent, float x = 0.f, float y = 0.f, float z = 0.f) : parent(parent), x(x), y(y), z(z) {}
+
+	ecs::EntityId parent;
+	float x, y, z; // Offset from the parent
+
+	unsigned depth = 1U; // Children of unparented entities are at depth one
+	float originX = std::numeric_limits<float>::quiet_NaN(); // World position of the parent when last propagated
+	float originY = std::numeric_limits<float>::quiet_NaN();
+	float originZ = std::numeric_limits<float>::quiet_NaN();
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <Engine/Mathematics.hpp>
+
+// Current wind, shared by the systems through EntityManager::context
+struct Wind
+{
+	math::Vector force;
+};
\ No newline at end of file
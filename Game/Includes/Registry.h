@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Engine/Family.hpp>
+#include <Engine/Entities/System/WorldTraits.hpp>
+
+// Components (complete, the entity manager allocates their collections upfront)
+#include "Component/Transform.h"
+#include "Component/Motion.h"
+#include "Component/Body.h"
+#include "Component/Render.h"
+#include "Component/Camera.h"
+#include "Component/Joystick.h"
+#include "Component/Hierarchy.h"
+
+// Contexts (complete as well, constructed along with the world)
+#include "Context/Wind.h"
+
+// Messages
+struct Collision;
+struct Explosion;
+struct Weather;
+struct StartGameMessage;
+struct PauseGameMessage;
+struct LoadMessage;
+struct LoadingMessage;
+struct LoadedMessage;
+
+// Compile-time identifiers of the game types, must be included first in every translation unit
+template <>
+struct Registry<ComponentFamily>
+{
+	using types = TypeList<Transform, Motion, Body, Render, Camera, Joystick, Hierarchy>;
+};
+
+template <>
+struct Registry<MessageFamily>
+{
+	using types = TypeList<Collision, Explosion, Weather, StartGameMessage, PauseGameMessage, LoadMessage, LoadingMessage, LoadedMessage>;
+};
+
+template <>
+struct Registry<ContextFamily>
+{
+	using types = TypeList<Wind>;
+};
+
+// Storage backend of the world, the game relying on sparse set features (groups, collections, sorting)
+template <>
+struct ecs::WorldTraits<>
+{
+	using type = ecs::EntityManager;
+};
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Registry.h"
+
 #include <Engine/Entities/System/SystemManager.hpp>
 
 #include "State.h"
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Registry.h"
+
 #include <SFML\Window\Event.hpp>
 #include <SFML\Graphics\Drawable.hpp>
 #include <SFML\Graphics\RenderTarget.hpp>
@@ -58,6 +58,10 @@ public:
 		}
 	}
 
+	ecs::SystemAccess access() const override {
+		return ecs::SystemAccess().writes<Transform>().reads<Motion, Body>().receives<EntityAdded, EntityRemoved>();
+	}
+
 	void handle(const EntityAdded& message) override {
 		DEBUG("Entity added %d", message.entityId);
 
@@ -9,6 +9,7 @@
 #include "../Component/Transform.h"
 #include "../Component/Motion.h"
 #include "../Component/Body.h"
+#include "../Component/Joystick.h"
 
 class DebugSystem : public ecs::System
 {
@@ -39,16 +40,14 @@ public:
 		window.setTitle("FPS: " + std::to_string(fps) + " - Min: " + std::to_string(minFPS));
 		window.setView(fixed);
 
-		entities->each<Motion, Transform, Body>([&](auto& entity, auto& motion, auto& transform, auto& body) {			
-			// Player stats
-			if (entity.has<Joystick>()) {
-				drawText(5.f, 4.f, sf::Color::Black, "Velocity = " + std::to_string(motion.velocity.x) + ", " + std::to_string(motion.velocity.y) + " = " + std::to_string(motion.velocity.magnitude()));
-				drawText(5.f, 24.f, sf::Color::Black, "Position = " + std::to_string(transform.x) + ", " + std::to_string(transform.y));
-				drawText(5.f, 44.f, sf::Color::Black, "Mass = " + std::to_string(body.mass));
-				drawText(5.f, 64.f, sf::Color::Black, "Max speed = " + std::to_string(motion.speed));
-				drawText(5.f, 84.f, sf::Color::Black, "Thrust = " + std::to_string(motion.thrust));
-				drawText(5.f, 104.f, sf::Color::Black, "View = " + std::to_string(current.getCenter().x) + ", " + std::to_string(current.getCenter().y));
-			}
+		// Player stats, driven by the joysticks rather than probing every body
+		entities->each<Joystick, Motion, Transform, Body>([&](auto& entity, auto& joystick, auto& motion, auto& transform, auto& body) {
+			drawText(5.f, 4.f, sf::Color::Black, "Velocity = " + std::to_string(motion.velocity.x) + ", " + std::to_string(motion.velocity.y) + " = " + std::to_string(motion.velocity.magnitude()));
+			drawText(5.f, 24.f, sf::Color::Black, "Position = " + std::to_string(transform.x) + ", " + std::to_string(transform.y));
+			drawText(5.f, 44.f, sf::Color::Black, "Mass = " + std::to_string(body.mass));
+			drawText(5.f, 64.f, sf::Color::Black, "Max speed = " + std::to_string(motion.speed));
+			drawText(5.f, 84.f, sf::Color::Black, "Thrust = " + std::to_string(motion.thrust));
+			drawText(5.f, 104.f, sf::Color::Black, "View = " + std::to_string(current.getCenter().x) + ", " + std::to_string(current.getCenter().y));
 
 			// Cartesian plane
 			//window.draw(xaxis, 2, sf::PrimitiveType::Lines);
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <limits>
+#include <Engine/Entities/System/System.hpp>
+
+#include "../Component/Transform.h"
+#include "../Component/Hierarchy.h"
+
+// Propagates the world transforms of the parents to their children, e.g. turrets attached to bodies
+class HierarchySystem final : public ecs::System
+{
+public:
+	void update(float delta) override {
+		auto& hierarchies = entities->collection<Hierarchy>();
+		auto& transforms = entities->collection<Transform>();
+		auto restructured = hierarchies.size() != count; // Removals leave no tick behind
+
+		// Hierarchies added or changed (thus maybe reparented) since the previous update are propagated anyway
+		entities->each<ecs::Changed<Hierarchy>>([&restructured](auto&, Hierarchy& hierarchy) {
+			hierarchy.originX = std::numeric_limits<float>::quiet_NaN();
+			restructured = true;
+		});
+
+		// Parents come before their children as long as the storage is sorted by depth
+		if (restructured) {
+			auto sorting = relevel(hierarchies) > INCREMENTAL_LIMIT ? ecs::Collection::Sorting::Full : ecs::Collection::Sorting::Incremental;
+			entities->sort<Hierarchy>([](const Hierarchy& left, const Hierarchy& right) { return left.depth < right.depth; }, sorting);
+			count = hierarchies.size();
+		}
+
+		// Single linear pass, a recomputed parent making its children dirty in turn
+		for (auto index = 0U; index < hierarchies.size(); ++index) {
+			auto entity = hierarchies.data()[index];
+			auto& hierarchy = hierarchies.at(index);
+
+			if (!transforms.contains(hierarchy.parent) || !transforms.contains(entity)) {
+				continue;
+			}
+
+			auto& parent = transforms.get(hierarchy.parent);
+
+			// Writes through references are not tracked, hence the parent position is compared to the cached one
+			if (parent.x == hierarchy.originX && parent.y == hierarchy.originY && parent.z == hierarchy.originZ) {
+				continue;
+			}
+
+			auto& transform = transforms.get(entity);
+
+			transform.x = parent.x + hierarchy.x;
+			transform.y = parent.y + hierarchy.y;
+			transform.z = parent.z + hierarchy.z;
+			hierarchy.originX = parent.x;
+			hierarchy.originY = parent.y;
+			hierarchy.originZ = parent.z;
+			transforms.touch(entity);
+		}
+	}
+
+	ecs::SystemAccess access() const override {
+		return ecs::SystemAccess().writes<Transform, Hierarchy>();
+	}
+
+private:
+	// Recomputes the depths, which takes a single pass when the storage is still sorted by the previous ones,
+	// returning the amount of positions where the depth decreases (thus how far the storage is from sorted)
+	unsigned relevel(ecs::ComponentCollection<Hierarchy>& hierarchies) const {
+		for (auto pass = 0U, moved = 1U; moved; ++pass) {
+			if (pass > hierarchies.size()) throw "Cyclic hierarchy";
+
+			moved = 0U;
+
+			for (auto index = 0U; index < hierarchies.size(); ++index) {
+				auto& hierarchy = hierarchies.at(index);
+				auto depth = hierarchies.contains(hierarchy.parent) ? hierarchies.get(hierarchy.parent).depth + 1U : 1U;
+
+				if (depth != hierarchy.depth) {
+					hierarchy.depth = depth;
+					moved++;
+				}
+			}
+		}
+
+		auto descents = 0U;
+
+		for (auto index = 1U; index < hierarchies.size(); ++index) {
+			descents += hierarchies.at(index).depth < hierarchies.at(index - 1U).depth;
+		}
+
+		return descents;
+	}
+
+private:
+	static constexpr unsigned INCREMENTAL_LIMIT = 64U; // Descents beyond which the insertion sort gives way to a full one
+
+	unsigned count = 0U; // Hierarchies as of the previous update
+};
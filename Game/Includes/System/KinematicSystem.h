@@ -2,40 +2,41 @@
 
 #include <Engine/Entities/System/System.hpp>
 
-#include "../Message/Weather.h"
+#include "../Context/Wind.h"
 #include "../Component/Transform.h"
 #include "../Component/Motion.h"
 #include "../Component/Body.h"
 
-class KinematicSystem : public ecs::SystemListener<Weather>
+class KinematicSystem : public ecs::System
 {
 public:
 	void update(float time) override {
-		entities->each<Transform, Motion, Body>([&](auto& e, Transform& transform, Motion& motion, Body& body) {
-			auto terrainFriction = 20.f; // 1 is no friction
-			auto shoesTraction = 0.f; // 0 is no traction
+		auto terrainFriction = 20.f; // 1 is no friction
+		auto shoesTraction = 0.f; // 0 is no traction
 
-			auto friction = std::max(1.f, terrainFriction) + shoesTraction;
-			auto windAcceleration = windForce / body.mass; // Wind acceleration upon the entity
-			
-			// Apply wind and friction
-			motion.velocity += windAcceleration * time;
-			motion.velocity *= std::powf(1.f / friction, time);
+		auto friction = std::max(1.f, terrainFriction) + shoesTraction;
+		auto damping = std::pow(1.f / friction, time); // Same for every body, hence out of the loop
+		auto windForce = entities->context<Wind>().force;
 
-			auto displacement = motion.velocity * time;
+		// Plain loops over the dense arrays (a single run, as the components are grouped)
+		entities->parallelEachChunk<Transform, Motion, Body>([&](auto, ecs::Span<Transform> transforms, ecs::Span<Motion> motions, ecs::Span<Body> bodies) {
+			for (auto index = 0U; index < transforms.size(); ++index) {
+				auto& motion = motions[index];
+				auto windAcceleration = windForce / bodies[index].mass; // Wind acceleration upon the entity
 
-			transform.x += displacement.x;
-			transform.y += displacement.y;
+				// Apply wind and friction
+				motion.velocity += windAcceleration * time;
+				motion.velocity *= damping;
+
+				auto displacement = motion.velocity * time;
+
+				transforms[index].x += displacement.x;
+				transforms[index].y += displacement.y;
+			}
 		});
 	}
 
-	void handle(const Weather& weather) override {
-		TRACE("Weather changed! Force: %.2f, Angle: %.2f", weather.windStrenght, weather.windAngle.degrees());
-		windForce = math::Vector::polar(weather.windStrenght, weather.windAngle);
+	ecs::SystemAccess access() const override {
+		return ecs::SystemAccess().writes<Transform, Motion>().reads<Body>().readsContext<Wind>();
 	}
-
-private:
-	float windStrenght = 0.f;
-	float windAngle = 0.f;
-	math::Vector windForce;
 };
\ No newline at end of file
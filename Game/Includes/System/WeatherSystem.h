@@ -5,6 +5,9 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <Engine/Entities/System/System.hpp>
 
+#include "../Message/Weather.h"
+#include "../Context/Wind.h"
+
 class WeatherSystem final : public ecs::System
 {
 public:
@@ -16,11 +19,16 @@ public:
 		if (accumulator >= timeToChange) {
 			auto strenght = randomStrenght(randomEngine);
 			auto angle = randomRadians(randomEngine);
+			entities->context<Wind>().force = math::Vector::polar(strenght, math::Angle::radians(angle));
 			messages->publish<Weather>(strenght, math::Angle::radians(angle));
 			accumulator = 0.f;
 		}
 	}
 
+	ecs::SystemAccess access() const override {
+		return ecs::SystemAccess().writesContext<Wind>().publishes<Weather>();
+	}
+
 private:
 	float accumulator = 0.f;
 	float timeToChange = 5.f;
@@ -1,3 +1,5 @@
+#include "Includes/Registry.h"
+
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/Sprite.hpp>
@@ -30,6 +32,7 @@
 #include "Includes/System/JoystickSystem.h"
 #include "Includes/System/DebugSystem.h"
 #include "Includes/System/CollisionSystem.h"
+#include "Includes/System/HierarchySystem.h"
 #include "Includes/System/CameraSystem.h"
 #include "Includes/System/BackgroundSystem.h"
 #include "Includes/System/WeatherSystem.h"
@@ -56,11 +59,14 @@ ENTRY_POINT
 
 	// Managers startup
 	auto messages = std::make_shared<mqs::MessageManager>();
-	auto entities = std::make_shared<ecs::EntityManager>(messages);
+	auto entities = std::make_shared<ecs::World>(messages);
 	auto systems = std::make_shared<ecs::SystemManager>(entities, messages);
 	auto states = std::make_shared<sts::StateManager>(messages); // (systems, messages)
 
-	std::stack<unsigned> actions;
+	// Keeps the entities iterated by the physics and debug systems packed together
+	entities->group<Motion, Transform, Body>();
+
+	std::stack<ecs::EntityId> actions;
 
 	// Resources startup: Fonts
 	FontStore::load("Resources\\Fonts", [](const std::string& path) {
@@ -76,10 +82,12 @@ ENTRY_POINT
 		return texture;
 	});
 
-	// Message hooking for debugging purposes
+#ifdef TRACE_MESSAGES
+	// Message hooking for debugging purposes (hooks make every message published, even without handlers)
 	messages->hook([](const mqs::Message& message) {
-		//DEBUG("Hooked message: id = %d, uid = %d, family = %d", message.id, message.uid(), message.family);
+		DEBUG("Hooked message: id = %d, uid = %d, family = %d", message.id, message.uid(), message.family);
 	});
+#endif
 
 	// State transition setup
 	states->
@@ -102,6 +110,7 @@ ENTRY_POINT
 	systems->add<JoystickSystem>(window);
 	systems->add<KinematicSystem>();
 	systems->add<CollisionSystem>(window);
+	systems->add<HierarchySystem>();
 	//systems->add<CameraSystem>(window);
 	systems->add<BackgroundSystem>(window);
 	systems->add<RenderSystem>(window);